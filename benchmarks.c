@@ -1,14 +1,25 @@
-#include "error/error.h"
-
-#include "dsl/benchmarks.c"
-#include "fix/benchmarks.c"
-#include "malloc2/benchmarks.c"
-
-int main() {
-  fix_benchmarks();
-  malloc2_benchmarks();
-  dsl_benchmarks();
-
-  hc_errors_deinit();
-  return 0;
-}
+#include "error/error.h"
+
+#include "chrono/benchmarks.c"
+#include "dsl/benchmarks.c"
+#include "fix/benchmarks.c"
+#include "malloc2/benchmarks.c"
+#include "slog/benchmarks.c"
+#include "stream1/benchmarks.c"
+#include "stream2/benchmarks.c"
+#include "task/benchmarks.c"
+
+int main() {
+  hc_clock_init(hc_clock(), HC_CLOCK_TSC);
+  chrono_benchmarks();
+  fix_benchmarks();
+  malloc2_benchmarks();
+  dsl_benchmarks();
+  stream1_benchmarks();
+  stream2_benchmarks();
+  slog_benchmarks();
+  task_benchmarks();
+
+  hc_errors_deinit();
+  return 0;
+}
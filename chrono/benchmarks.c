@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "chrono.h"
+#include "stream1/stream1.h"
+
+#define TIME_REPS 1000000
+
+void chrono_benchmarks() {
+  hc_time_t now = hc_now(), t = now;
+  char buf[HC_TIME_LENGTH_MAX];
+  
+  for (int i = 0; i < TIME_REPS; i++) {
+    free(hc_time_sprintf(&now, HC_TIME_FORMAT));
+  }
+
+  hc_time_print(&t, "sprintf: ");
+  t = hc_now();
+  
+  for (int i = 0; i < TIME_REPS; i++) {
+    hc_time_format(&now, HC_TIME_FORMAT, buf, sizeof(buf));
+  }
+
+  hc_time_print(&t, "format cached: ");
+  hc_time_t x = now;
+  t = hc_now();
+  
+  for (int i = 0; i < TIME_REPS; i++) {
+    x.value.tv_sec++;
+    hc_time_format(&x, HC_TIME_FORMAT, buf, sizeof(buf));
+  }
+
+  hc_time_print(&t, "format uncached: ");
+  t = hc_now();
+  
+  for (int i = 0; i < TIME_REPS; i++) {
+    hc_time_parse("2025-04-13T01:40:05", &x);
+  }
+
+  hc_time_print(&t, "parse: ");
+
+  const struct {
+    enum hc_clock_source source;
+    const char *name;
+  } clocks[] = {
+    {HC_CLOCK_MONOTONIC, "monotonic"},
+    {HC_CLOCK_COARSE, "coarse"},
+    {HC_CLOCK_TSC, "tsc"},
+    {HC_CLOCK_TSCP, "tscp"}
+  };
+
+  for (int i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++) {
+    struct hc_clock c;
+    hc_clock_init(&c, clocks[i].source);
+    const hc_ns_t start = hc_clock_now(&c);
+    
+    for (int j = 0; j < TIME_REPS; j++) {
+      hc_clock_now(&c);
+    }
+
+    const hc_ns_t ns = hc_clock_now(&c) - start;
+    
+    printf("clock %s%s: %.1fns/call\n",
+	   clocks[i].name,
+	   (c.source == clocks[i].source) ? "" : " (fallback)",
+	   (double)ns / TIME_REPS);
+  }
+
+  // Distribution of back to back reads, which is the smallest interval
+  // the clock is able to measure.
+  struct hc_clock c;
+  hc_clock_init(&c, HC_CLOCK_TSC);
+  struct hc_histogram h;
+  hc_histogram_init(&h);
+  
+  for (int i = 0; i < TIME_REPS; i++) {
+    const hc_ns_t start = hc_clock_now(&c);
+    hc_histogram_record(&h, hc_clock_now(&c) - start);
+  }
+
+  hc_puts(hc_stdout(), "clock resolution: ");
+  hc_histogram_print(&h, hc_stdout());
+  hc_putc(hc_stdout(), '\n');
+  fflush(stdout);
+  hc_histogram_deinit(&h);
+
+  // Per zone overhead with the process clock, which is configured on
+  // startup.
+  hc_profile_clear();
+  const hc_ns_t start = hc_ns();
+    
+  for (int i = 0; i < TIME_REPS; i++) {
+    hc_profile_do("bench") {}
+  }
+
+  const hc_ns_t ns = hc_ns() - start;
+    
+  printf("profile %s: %.1fns/zone\n",
+	 clocks[hc_clock()->source].name, (double)ns / TIME_REPS);
+
+  hc_profile_clear();
+}
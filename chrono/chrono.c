@@ -1,95 +1,1176 @@
-#include <errno.h>
-#include <inttypes.h>
-#include <stdio.h>
-#include <stdlib.h>
-
-#include "chrono.h"
-#include "error/error.h"
-#include "stream1/stream1.h"
-
-hc_time_t hc_now() {
-  hc_time_t t;
-  
-  if (!timespec_get(&t.value, TIME_UTC)) {
-    hc_throw("Failed getting time: %d", errno);
-  }
-
-  return t;
-}
-
-hc_time_t hc_time(int year,
-		  int month,
-		  int day,
-		  int hour,
-		  int minute,
-		  int second) {
-  struct tm t = {0};
-  t.tm_year = year - 1900;
-  t.tm_mon = month - 1;
-  t.tm_mday = day;
-  t.tm_hour = hour;
-  t.tm_min = minute;
-  t.tm_sec = second;
-
-  hc_time_t result = {0};
-  result.value.tv_sec = timegm(&t);
-  return result;
-}
-
-uint64_t hc_time_ns(const hc_time_t *t) {
-  const struct timespec now = hc_now().value;
-  
-  return
-    (now.tv_sec - t->value.tv_sec) * 1000000000 +
-    (now.tv_nsec - t->value.tv_nsec);
-}
-
-void hc_time_print(const hc_time_t *t, const char *m) {
-  printf("%s%" PRIu64 "ns\n", m, hc_time_ns(t));
-}
-
-char *hc_time_sprintf(const hc_time_t *t, const char *spec) {
-  struct tm tm;
-  gmtime_r(&(t->value.tv_sec), &tm);
-  size_t len = 8;
-  char *result = malloc(len);
-
-  for (;;) {
-    const size_t n = strftime(result, len, spec, &tm);
-
-    if (n) {
-      result[n] = 0;
-      break;
-    }
-    
-    len *= 2;
-    free(result);
-    result = malloc(len);
-  }
-    
-  return result;
-}
-
-void hc_time_printf(const hc_time_t *t,
-		    const char *spec,
-		    struct hc_stream *out) {
-  char *s = hc_time_sprintf(t, "%Y-%m-%dT%H:%M:%S");
-  hc_puts(out, s);
-  free(s);
-}
-
-uint64_t hc_sleep(uint64_t ns) {
-  struct timespec t = {0};
-  t.tv_nsec = ns;
-
-  switch (nanosleep(&t, &t)) {
-  case 0:
-    break;
-  case EINTR:
-    return t.tv_nsec;
-  default:
-    hc_throw("Failed sleeping: %d", errno);
-  }
-
-  return 0;
-}
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define HC_TSC
+#endif
+
+#include "chrono.h"
+#include "error/error.h"
+#include "stream1/stream1.h"
+
+hc_time_t hc_now() {
+  hc_time_t t;
+  
+  if (!timespec_get(&t.value, TIME_UTC)) {
+    hc_throw("Failed getting time: %d", errno);
+  }
+
+  return t;
+}
+
+hc_time_t hc_time(int year,
+		  int month,
+		  int day,
+		  int hour,
+		  int minute,
+		  int second) {
+  struct tm t = {0};
+  t.tm_year = year - 1900;
+  t.tm_mon = month - 1;
+  t.tm_mday = day;
+  t.tm_hour = hour;
+  t.tm_min = minute;
+  t.tm_sec = second;
+
+  hc_time_t result = {0};
+  result.value.tv_sec = timegm(&t);
+  return result;
+}
+
+uint64_t hc_time_ns(const hc_time_t *t) {
+  const struct timespec now = hc_now().value;
+  
+  return
+    (now.tv_sec - t->value.tv_sec) * 1000000000 +
+    (now.tv_nsec - t->value.tv_nsec);
+}
+
+void hc_time_print(const hc_time_t *t, const char *m) {
+  printf("%s%" PRIu64 "ns\n", m, hc_time_ns(t));
+}
+
+// Days since 1970-01-01, from Howard Hinnant's date algorithms.
+static int64_t days_from_civil(int64_t y, const int m, const int d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int64_t *y, int *m, int *d) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const int64_t doe = z - era * 146097;
+  const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int64_t mp = (5 * doy + 2) / 153;
+  *d = doy - (153 * mp + 2) / 5 + 1;
+  *m = mp < 10 ? mp + 3 : mp - 9;
+  *y = yoe + era * 400 + (*m <= 2);
+}
+
+static char *put_digits(char *p, int v, int n) {
+  for (int i = n - 1; i >= 0; i--, v /= 10) {
+    p[i] = '0' + v % 10;
+  }
+
+  return p + n;
+}
+
+#define ISO_LENGTH 19
+#define ISO_DATE_LENGTH 11
+
+static int64_t split_day(const time_t t, int *seconds) {
+  int64_t days = t / 86400;
+  int s = t % 86400;
+  
+  if (s < 0) {
+    s += 86400;
+    days--;
+  }
+
+  *seconds = s;
+  return days;
+}
+
+static void iso_format_time(const int s, char *out) {
+  char *p = put_digits(out, s / 3600, 2);
+  *p++ = ':';
+  p = put_digits(p, s / 60 % 60, 2);
+  *p++ = ':';
+  p = put_digits(p, s % 60, 2);
+  *p = 0;
+}
+
+static size_t iso_format(const time_t t, char *out) {
+  int s;
+  const int64_t days = split_day(t, &s);
+  int64_t y;
+  int m, d;
+  civil_from_days(days, &y, &m, &d);
+
+  // Falls back to strftime() for years that don't fit in four digits.
+  if (y < 0 || y > 9999) {
+    return 0;
+  }
+
+  char *p = put_digits(out, y, 4);
+  *p++ = '-';
+  p = put_digits(p, m, 2);
+  *p++ = '-';
+  p = put_digits(p, d, 2);
+  *p++ = 'T';
+  iso_format_time(s, p);
+  return ISO_LENGTH;
+}
+
+struct time_cache {
+  bool valid;
+  time_t t;
+  size_t length;
+  char spec[32];
+  char data[HC_TIME_LENGTH_MAX];
+};
+
+size_t hc_time_format(const hc_time_t *t,
+		      const char *spec,
+		      char *out,
+		      const size_t n) {
+  // Consecutive calls mostly format the same second.
+  static __thread struct time_cache cache = {.valid = false};
+  const time_t s = t->value.tv_sec;
+  
+  if (!cache.valid || s != cache.t || strcmp(spec, cache.spec) != 0) {
+    size_t length = 0;
+    
+    if (strcmp(spec, HC_TIME_FORMAT) == 0) {
+      int ds, cs;
+      
+      // The date is reused as long as the day stays the same.
+      if (cache.valid && cache.length == ISO_LENGTH &&
+	  strcmp(cache.spec, HC_TIME_FORMAT) == 0 &&
+	  split_day(cache.t, &cs) == split_day(s, &ds)) {
+	iso_format_time(ds, cache.data + ISO_DATE_LENGTH);
+	length = ISO_LENGTH;
+      } else {
+	length = iso_format(s, cache.data);
+      }
+    }
+
+    if (!length) {
+      struct tm tm;
+      gmtime_r(&s, &tm);
+      length = strftime(cache.data, sizeof(cache.data), spec, &tm);
+    }
+
+    // Specs that don't fit aren't cached.
+    const size_t spec_length = strlen(spec);
+    cache.valid = spec_length < sizeof(cache.spec);
+    if (cache.valid) { memcpy(cache.spec, spec, spec_length + 1); }
+    cache.t = s;
+    cache.length = length;
+  }
+
+  if (!cache.length || cache.length >= n) {
+    return 0;
+  }
+  
+  memcpy(out, cache.data, cache.length + 1);
+  return cache.length;
+}
+
+char *hc_time_sprintf(const hc_time_t *t, const char *spec) {
+  char buf[HC_TIME_LENGTH_MAX];
+  
+  if (hc_time_format(t, spec, buf, sizeof(buf))) {
+    return strdup(buf);
+  }
+  
+  struct tm tm;
+  gmtime_r(&(t->value.tv_sec), &tm);
+  size_t len = sizeof(buf) * 2;
+  char *result = malloc(len);
+
+  // Empty results are indistinguishable from running out of space.
+  for (;;) {
+    const size_t n = strftime(result, len, spec, &tm);
+
+    if (n || len >= HC_TIME_LENGTH_MAX * 64) {
+      result[n] = 0;
+      break;
+    }
+    
+    len *= 2;
+    free(result);
+    result = malloc(len);
+  }
+    
+  return result;
+}
+
+void hc_time_printf(const hc_time_t *t,
+		    const char *spec,
+		    struct hc_stream *out) {
+  char buf[HC_TIME_LENGTH_MAX];
+  const size_t n = hc_time_format(t, spec, buf, sizeof(buf));
+  
+  if (n) {
+    hc_write(out, (const uint8_t *)buf, n);
+  } else {
+    char *s = hc_time_sprintf(t, spec);
+    hc_puts(out, s);
+    free(s);
+  }
+}
+
+static bool parse_digits(const char **in, const int n, int *out) {
+  int v = 0;
+  
+  for (int i = 0; i < n; i++) {
+    const char c = (*in)[i];
+    if (c < '0' || c > '9') { return false; }
+    v = v * 10 + c - '0';
+  }
+
+  *in += n;
+  *out = v;
+  return true;
+}
+
+static bool parse_char(const char **in, const char c) {
+  if (**in != c) { return false; }
+  (*in)++;
+  return true;
+}
+
+static int days_in_month(const int y, const int m) {
+  static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+  return days[m - 1] + (m == 2 && leap);
+}
+
+const char *hc_time_parse(const char *in, hc_time_t *out) {
+  int y, m, d, h, mi, s;
+
+  if (!parse_digits(&in, 4, &y) || !parse_char(&in, '-') ||
+      !parse_digits(&in, 2, &m) || !parse_char(&in, '-') ||
+      !parse_digits(&in, 2, &d) ||
+      !(parse_char(&in, 'T') || parse_char(&in, ' ')) ||
+      !parse_digits(&in, 2, &h) || !parse_char(&in, ':') ||
+      !parse_digits(&in, 2, &mi) || !parse_char(&in, ':') ||
+      !parse_digits(&in, 2, &s)) {
+    return NULL;
+  }
+
+  if (m < 1 || m > 12 || d < 1 || d > days_in_month(y, m) ||
+      h > 23 || mi > 59 || s > 60) {
+    return NULL;
+  }
+
+  long ns = 0;
+
+  // Fractions beyond nanoseconds are ignored.
+  if (parse_char(&in, '.')) {
+    if (*in < '0' || *in > '9') { return NULL; }
+    
+    for (long scale = 100000000; *in >= '0' && *in <= '9'; in++) {
+      ns += (*in - '0') * scale;
+      scale /= 10;
+    }
+  }
+
+  int64_t offset = 0;
+  
+  if (!parse_char(&in, 'Z') && (*in == '+' || *in == '-')) {
+    const int sign = (*in++ == '-') ? -1 : 1;
+    int oh, om;
+
+    if (!parse_digits(&in, 2, &oh)) { return NULL; }
+    parse_char(&in, ':');
+    
+    if (!parse_digits(&in, 2, &om) || oh > 23 || om > 59) {
+      return NULL;
+    }
+
+    offset = sign * (oh * 3600 + om * 60);
+  }
+
+  out->value.tv_sec =
+    days_from_civil(y, m, d) * 86400 + h * 3600 + mi * 60 + s - offset;
+  
+  out->value.tv_nsec = ns;
+  return in;
+}
+
+uint64_t hc_sleep(uint64_t ns) {
+  struct timespec t = {0};
+  t.tv_sec = ns / 1000000000;
+  t.tv_nsec = ns % 1000000000;
+
+  if (nanosleep(&t, &t) == -1) {
+    if (errno == EINTR) {
+      return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+    }
+    
+    hc_throw("Failed sleeping: %d", errno);
+  }
+
+  return 0;
+}
+
+#define TSC_SHIFT 32
+#define TSC_CALIBRATION_NS 10000000
+
+// Clock ids are checked on init, clock_gettime() can't fail after that.
+static hc_ns_t clock_ns(const clockid_t id) {
+  struct timespec t;
+  clock_gettime(id, &t);
+  return (hc_ns_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+#ifdef HC_TSC
+
+static bool tsc_invariant() {
+  unsigned int a, b, c, d;
+  
+  if (!__get_cpuid(0x80000000, &a, &b, &c, &d) || a < 0x80000007) {
+    return false;
+  }
+
+  __get_cpuid(0x80000007, &a, &b, &c, &d);
+  return d & (1 << 8);
+}
+
+static bool tscp_supported() {
+  unsigned int a, b, c, d;
+  return __get_cpuid(0x80000001, &a, &b, &c, &d) && (d & (1 << 27));
+}
+
+static uint64_t tsc_read(const enum hc_clock_source source) {
+  unsigned int aux;
+  return (source == HC_CLOCK_TSCP) ? __rdtscp(&aux) : __rdtsc();
+}
+
+static void tsc_calibrate(struct hc_clock *c) {
+  const hc_ns_t ns_start = clock_ns(CLOCK_MONOTONIC);
+  const uint64_t tsc_start = tsc_read(c->source);
+  hc_ns_t ns_end;
+
+  // Spins rather than sleeps to keep the measurement tight.
+  do {
+    ns_end = clock_ns(CLOCK_MONOTONIC);
+  } while (ns_end - ns_start < TSC_CALIBRATION_NS);
+
+  const uint64_t tsc_end = tsc_read(c->source);
+  
+  c->mult =
+    ((unsigned __int128)(ns_end - ns_start) << TSC_SHIFT) /
+    (tsc_end - tsc_start);
+
+  c->tsc_base = tsc_end;
+  c->ns_base = ns_end;
+}
+
+static hc_ns_t tsc_ns(const struct hc_clock *c, const uint64_t tsc) {
+  const uint64_t ticks = tsc - c->tsc_base;
+  return c->ns_base + (((unsigned __int128)ticks * c->mult) >> TSC_SHIFT);
+}
+
+#endif
+
+struct hc_clock *hc_clock_init(struct hc_clock *c,
+			       enum hc_clock_source source) {
+  c->source = source;
+  c->tsc_base = c->mult = c->ns_base = 0;
+  struct timespec t;
+  
+  if (source == HC_CLOCK_COARSE &&
+      clock_getres(CLOCK_MONOTONIC_COARSE, &t) == -1) {
+    c->source = HC_CLOCK_MONOTONIC;
+  }
+
+  if (source == HC_CLOCK_TSC || source == HC_CLOCK_TSCP) {
+    // Falls back to the monotonic clock without a TSC that ticks at a
+    // constant rate across cores and power states.
+#ifdef HC_TSC
+    if (tsc_invariant() && (source == HC_CLOCK_TSC || tscp_supported())) {
+      tsc_calibrate(c);
+    } else {
+      c->source = HC_CLOCK_MONOTONIC;
+    }
+#else
+    c->source = HC_CLOCK_MONOTONIC;
+#endif
+  }
+
+  return c;
+}
+
+hc_ns_t hc_clock_now(const struct hc_clock *c) {
+  switch (c->source) {
+  case HC_CLOCK_COARSE:
+    return clock_ns(CLOCK_MONOTONIC_COARSE);
+#ifdef HC_TSC
+  case HC_CLOCK_TSC:
+  case HC_CLOCK_TSCP: {
+    return tsc_ns(c, tsc_read(c->source));
+  }
+#endif
+  default:
+    break;
+  }
+
+  return clock_ns(CLOCK_MONOTONIC);
+}
+
+// Shared by all threads and read without synchronization, which means
+// it may only be configured on startup before any threads are started.
+struct hc_clock *hc_clock() {
+  static struct hc_clock c = {.source = HC_CLOCK_MONOTONIC};
+  return &c;
+}
+
+hc_ns_t hc_ns() {
+  return hc_clock_now(hc_clock());
+}
+
+/* Histogram */
+
+// Values below 2^precision get a bucket each, after that every power of
+// two is split into 2^(precision - 1) buckets.
+
+static size_t bucket_index(const struct hc_histogram *h, const uint64_t v) {
+  const int p = h->opts.precision;
+  if (v < (1ULL << p)) { return v; }
+  const int shift = 63 - __builtin_clzll(v) - p + 1;
+  return ((size_t)shift << (p - 1)) + (v >> shift);
+}
+
+static uint64_t bucket_max(const struct hc_histogram *h, const size_t i) {
+  const int p = h->opts.precision;
+  if (i < (1ULL << p)) { return i; }
+  const int shift = (i >> (p - 1)) - 1;
+  const uint64_t low = (i - ((size_t)shift << (p - 1))) << shift;
+  return low + ((1ULL << shift) - 1);
+}
+
+struct hc_histogram *_hc_histogram_init(struct hc_histogram *h,
+					const struct hc_histogram_opts opts) {
+  assert(opts.precision > 1 && opts.precision < 16);
+  h->opts = opts;
+  h->length = (size_t)(66 - opts.precision) << (opts.precision - 1);
+  h->counts = calloc(h->length, sizeof(uint64_t));
+  h->total = h->max = 0;
+  h->min = UINT64_MAX;
+  return h;
+}
+
+void hc_histogram_deinit(struct hc_histogram *h) {
+  free(h->counts);
+}
+
+// Each histogram has a single writer, which means that plain loads and
+// stores are enough; they're atomic to allow reading from other threads.
+
+#define relaxed_store(p, v)			\
+  __atomic_store_n(p, v, __ATOMIC_RELAXED)
+
+#define relaxed_load(p)				\
+  __atomic_load_n(p, __ATOMIC_RELAXED)
+
+void hc_histogram_record(struct hc_histogram *h, const uint64_t value) {
+  uint64_t *c = h->counts + bucket_index(h, value);
+  relaxed_store(c, relaxed_load(c) + 1);
+  relaxed_store(&h->total, relaxed_load(&h->total) + 1);
+  if (value < h->min) { relaxed_store(&h->min, value); }
+  if (value > h->max) { relaxed_store(&h->max, value); }
+}
+
+void hc_histogram_merge(struct hc_histogram *dst,
+			const struct hc_histogram *src) {
+  assert(dst->opts.precision == src->opts.precision);
+  
+  for (size_t i = 0; i < src->length; i++) {
+    dst->counts[i] += relaxed_load(src->counts + i);
+  }
+
+  dst->total += relaxed_load(&src->total);
+  const uint64_t min = relaxed_load(&src->min);
+  const uint64_t max = relaxed_load(&src->max);
+  if (min < dst->min) { dst->min = min; }
+  if (max > dst->max) { dst->max = max; }
+}
+
+void hc_histogram_clear(struct hc_histogram *h) {
+  memset(h->counts, 0, h->length * sizeof(uint64_t));
+  h->total = h->max = 0;
+  h->min = UINT64_MAX;
+}
+
+uint64_t hc_histogram_percentile(const struct hc_histogram *h,
+				 const double p) {
+  if (!h->total) { return 0; }
+  uint64_t n = p / 100.0 * h->total + 0.5;
+  if (n < 1) { n = 1; }
+  uint64_t seen = 0;
+  
+  for (size_t i = 0; i < h->length; i++) {
+    seen += h->counts[i];
+
+    if (seen >= n) {
+      const uint64_t v = bucket_max(h, i);
+      return (v > h->max) ? h->max : v;
+    }
+  }
+
+  return h->max;
+}
+
+void hc_histogram_print(const struct hc_histogram *h, struct hc_stream *out) {
+  hc_printf(out,
+	    "n=%" PRIu64 " min=%" PRIu64
+	    " p50=%" PRIu64 " p90=%" PRIu64
+	    " p99=%" PRIu64 " p999=%" PRIu64
+	    " max=%" PRIu64,
+	    h->total, h->total ? h->min : 0,
+	    hc_histogram_percentile(h, 50),
+	    hc_histogram_percentile(h, 90),
+	    hc_histogram_percentile(h, 99),
+	    hc_histogram_percentile(h, 99.9),
+	    h->max);
+}
+
+/* Timers */
+
+#define TIMER_BITS 8
+#define TIMER_MASK (HC_TIMER_SLOTS - 1)
+
+static void timer_insert(struct hc_timer_wheel *w, struct hc_timer *t) {
+  uint64_t delta = t->expires - w->now;
+  int level = 0;
+
+  // Timers that don't fit are parked at the end and cascaded down later.
+  for (; level < HC_TIMER_LEVELS - 1 &&
+	 delta >= (1ULL << (TIMER_BITS * (level + 1)));
+       level++);
+
+  if (delta >= (1ULL << (TIMER_BITS * HC_TIMER_LEVELS))) {
+    delta = (1ULL << (TIMER_BITS * HC_TIMER_LEVELS)) - 1;
+  }
+  
+  const uint64_t at = (level == HC_TIMER_LEVELS - 1)
+    ? w->now + delta
+    : t->expires;
+  
+  const size_t slot = (at >> (TIMER_BITS * level)) & TIMER_MASK;
+  hc_list_push_back(&w->slots[level][slot], &t->list);
+}
+
+struct hc_timer_wheel *_hc_timer_wheel_init(struct hc_timer_wheel *w,
+					    const struct hc_timer_wheel_opts opts) {
+  assert(opts.resolution);
+  w->opts = opts;
+  w->origin = hc_ns();
+  w->now = 0;
+  w->count = 0;
+
+  for (int i = 0; i < HC_TIMER_LEVELS; i++) {
+    for (int j = 0; j < HC_TIMER_SLOTS; j++) {
+      hc_list_init(&w->slots[i][j]);
+    }
+  }
+
+  return w;
+}
+
+struct hc_timer *hc_timer_init(struct hc_timer *t, hc_timer_callback callback) {
+  hc_list_init(&t->list);
+  t->callback = callback;
+  t->expires = 0;
+  return t;
+}
+
+bool hc_timer_active(const struct hc_timer *t) {
+  return !hc_list_nil(&t->list);
+}
+
+void hc_timer_start(struct hc_timer_wheel *w,
+		    struct hc_timer *t,
+		    const hc_ns_t deadline) {
+  if (hc_timer_active(t)) { hc_timer_cancel(w, t); }
+  const hc_ns_t r = w->opts.resolution;
+
+  // Rounds up, timers never fire early.
+  const uint64_t expires = (deadline > w->origin)
+    ? (deadline - w->origin + r - 1) / r
+    : 0;
+
+  t->expires = (expires > w->now) ? expires : w->now + 1;
+  timer_insert(w, t);
+  w->count++;
+}
+
+void hc_timer_cancel(struct hc_timer_wheel *w, struct hc_timer *t) {
+  if (hc_timer_active(t)) {
+    hc_list_delete(&t->list);
+    hc_list_init(&t->list);
+    w->count--;
+  }
+}
+
+static void timer_cascade(struct hc_timer_wheel *w, const int level) {
+  struct hc_list *slot =
+    &w->slots[level][(w->now >> (TIMER_BITS * level)) & TIMER_MASK];
+  
+  for (struct hc_list *i; (i = hc_list_pop_front(slot));) {
+    timer_insert(w, hc_baseof(i, struct hc_timer, list));
+  }
+}
+
+static bool timer_level_empty(const struct hc_timer_wheel *w,
+			      const int level) {
+  for (int i = 0; i < HC_TIMER_SLOTS; i++) {
+    if (!hc_list_nil(&w->slots[level][i])) { return false; }
+  }
+
+  return true;
+}
+
+size_t hc_timer_wheel_advance(struct hc_timer_wheel *w, const hc_ns_t now) {
+  const uint64_t target = (now - w->origin) / w->opts.resolution;
+  size_t result = 0;
+
+  if (!w->count) {
+    if (target > w->now) { w->now = target; }
+    return 0;
+  }
+  
+  while (w->now < target) {
+    // Empty slots are skipped up to the next one with timers.
+    uint64_t next = w->now + 1;
+
+    while ((next & TIMER_MASK) && hc_list_nil(&w->slots[0][next & TIMER_MASK])) {
+      next++;
+    }
+
+    // Empty levels are skipped up to the next cascade from above.
+    if (!(next & TIMER_MASK)) {
+      for (int level = 0;
+	   level < HC_TIMER_LEVELS - 1 && timer_level_empty(w, level);
+	   level++) {
+	next = (w->now | ((1ULL << (TIMER_BITS * (level + 1))) - 1)) + 1;
+      }
+    }
+
+    if (next > target) {
+      w->now = target;
+      break;
+    }
+
+    w->now = next;
+
+    // Higher levels are cascaded as lower levels wrap around.
+    for (int level = 1;
+	 level < HC_TIMER_LEVELS &&
+	   !((w->now >> (TIMER_BITS * (level - 1))) & TIMER_MASK);
+	 level++) {
+      timer_cascade(w, level);
+    }
+
+    struct hc_list *slot = &w->slots[0][w->now & TIMER_MASK];
+    
+    for (struct hc_list *i; (i = hc_list_pop_front(slot));) {
+      struct hc_timer *t = hc_baseof(i, struct hc_timer, list);
+      
+      // Timers parked beyond the range of the wheel go around again.
+      if (t->expires > w->now) {
+	timer_insert(w, t);
+	continue;
+      }
+      
+      hc_list_init(&t->list);
+      w->count--;
+      result++;
+      t->callback(t);
+    }
+
+    if (!w->count) {
+      w->now = target;
+      break;
+    }
+  }
+
+  return result;
+}
+
+hc_ns_t hc_timer_wheel_next(const struct hc_timer_wheel *w) {
+  if (!w->count) { return 0; }
+  uint64_t ticks = 1;
+
+  // Anything beyond the first level needs to be cascaded first, which
+  // happens when the first level wraps around.
+  for (; ticks < HC_TIMER_SLOTS; ticks++) {
+    const uint64_t at = w->now + ticks;
+    if (!(at & TIMER_MASK)) { break; }
+    if (!hc_list_nil(&w->slots[0][at & TIMER_MASK])) { break; }
+  }
+
+  return w->origin + (w->now + ticks) * w->opts.resolution;
+}
+
+/* Profile */
+
+// Exits are recorded without a name.
+struct profile_event {
+  const char *name;
+  uint64_t ticks;
+};
+
+struct profile_zone {
+  struct hc_profile_node *node;
+  uint64_t start;
+};
+
+// Everything except the trace head and node counters is only touched
+// by the owning thread, or while holding profile_lock when resetting.
+struct profile_thread {
+  struct hc_list list;
+  struct hc_profile tree;
+  struct profile_zone zones[HC_PROFILE_DEPTH_MAX];
+  size_t depth, head;
+  uint64_t generation;
+  int id;
+  struct profile_event trace[HC_PROFILE_TRACE_SIZE];
+};
+
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct hc_list profile_threads = {
+  .prev = &profile_threads, .next = &profile_threads
+};
+
+static int profile_thread_count = 0;
+static uint64_t profile_generation = 0;
+static __thread struct profile_thread *profile_current = NULL;
+
+// Raw counter values are recorded as is, conversion is deferred until
+// the profile is collected.
+
+static inline uint64_t profile_ticks() {
+#ifdef HC_TSC
+  const enum hc_clock_source source = hc_clock()->source;
+  
+  if (source == HC_CLOCK_TSC || source == HC_CLOCK_TSCP) {
+    return tsc_read(source);
+  }
+#endif
+
+  return hc_ns();
+}
+
+static hc_ns_t profile_ns(const uint64_t ticks) {
+#ifdef HC_TSC
+  const struct hc_clock *c = hc_clock();
+
+  if (c->source == HC_CLOCK_TSC || c->source == HC_CLOCK_TSCP) {
+    return tsc_ns(c, ticks);
+  }
+#endif
+
+  return ticks;
+}
+
+static hc_ns_t profile_span(const uint64_t ticks) {
+#ifdef HC_TSC
+  const struct hc_clock *c = hc_clock();
+
+  if (c->source == HC_CLOCK_TSC || c->source == HC_CLOCK_TSCP) {
+    return ((unsigned __int128)ticks * c->mult) >> TSC_SHIFT;
+  }
+#endif
+
+  return ticks;
+}
+
+struct profile_block {
+  struct hc_list list;
+  struct hc_profile_node nodes[HC_PROFILE_BLOCK_SIZE];
+};
+
+// Nodes are allocated in blocks and released all at once.
+
+static struct hc_profile_node *node_new(struct hc_profile *p) {
+  if (p->block_length == HC_PROFILE_BLOCK_SIZE) {
+    struct profile_block *b = malloc(sizeof(struct profile_block));
+    hc_list_push_back(&p->blocks, &b->list);
+    p->block_length = 0;
+  }
+
+  struct profile_block *b =
+    hc_baseof(hc_list_peek_back(&p->blocks), struct profile_block, list);
+
+  struct hc_profile_node *n = b->nodes + p->block_length++;
+  *n = (struct hc_profile_node){0};
+  return n;
+}
+
+// Nodes are linked in after they're initialized, which allows threads
+// collecting the profile to walk the tree while the owner is adding to
+// it.
+
+static void node_link(struct hc_profile_node *n,
+		      struct hc_profile_node *prev,
+		      struct hc_profile_node *c) {
+  c->parent = n;
+  
+  if (prev) {
+    __atomic_store_n(&prev->next, c, __ATOMIC_RELEASE);
+  } else {
+    __atomic_store_n(&n->child, c, __ATOMIC_RELEASE);
+  }
+}
+
+static struct hc_profile_node *node_child(struct hc_profile *p,
+					  struct hc_profile_node *n,
+					  const char *name) {
+  struct hc_profile_node *prev = NULL;
+
+  for (struct hc_profile_node *c = n->child; c; prev = c, c = c->next) {
+    if (c->name == name || strcmp(c->name, name) == 0) { return c; }
+  }
+
+  struct hc_profile_node *c = node_new(p);
+  c->name = name;
+  node_link(n, prev, c);
+  return c;
+}
+
+static hc_ns_t node_finish(struct hc_profile_node *n) {
+  hc_ns_t children = 0;
+
+  for (struct hc_profile_node *c = n->child; c; c = c->next) {
+    children += node_finish(c);
+  }
+
+  if (!n->parent) { n->total = children; }
+  n->self = (n->total > children) ? n->total - children : 0;
+  return n->total;
+}
+
+static void profile_tree_init(struct hc_profile *p) {
+  p->root = (struct hc_profile_node){.name = ""};
+  hc_list_init(&p->blocks);
+  p->block_length = HC_PROFILE_BLOCK_SIZE;
+}
+
+// Threads start over on their own once the profile has been cleared,
+// since they're the only ones who know when their tree isn't in use.
+// Zones that are open at that point are moved to the new tree.
+
+static void profile_reset(struct profile_thread *t) {
+  const size_t depth = hc_min(t->depth, HC_PROFILE_DEPTH_MAX);
+  const char *names[HC_PROFILE_DEPTH_MAX];
+  
+  for (size_t i = 0; i < depth; i++) {
+    names[i] = t->zones[i].node->name;
+  }
+  
+  pthread_mutex_lock(&profile_lock);
+  hc_profile_deinit(&t->tree);
+  profile_tree_init(&t->tree);
+  struct hc_profile_node *n = &t->tree.root;
+  
+  for (size_t i = 0; i < depth; i++) {
+    n = t->zones[i].node = node_child(&t->tree, n, names[i]);
+  }
+
+  __atomic_store_n(&t->head, 0, __ATOMIC_RELEASE);
+  t->generation = profile_generation;
+  pthread_mutex_unlock(&profile_lock);
+}
+
+static struct profile_thread *profile_thread() {
+  struct profile_thread *t = profile_current;
+
+  if (__builtin_expect(!t, false)) {
+    t = malloc(sizeof(struct profile_thread));
+    profile_tree_init(&t->tree);
+    t->depth = t->head = 0;
+    pthread_mutex_lock(&profile_lock);
+    t->generation = profile_generation;
+    t->id = profile_thread_count++;
+    hc_list_push_back(&profile_threads, &t->list);
+    pthread_mutex_unlock(&profile_lock);
+    profile_current = t;
+  } else if (__builtin_expect(t->generation !=
+			      __atomic_load_n(&profile_generation,
+					      __ATOMIC_RELAXED), false)) {
+    profile_reset(t);
+  }
+
+  return t;
+}
+
+// The trace is a ring of the most recent events, the head is bumped
+// after writing so readers know which events are complete.
+
+static inline void profile_trace(struct profile_thread *t,
+				 const char *name,
+				 const uint64_t ticks) {
+  const size_t i = t->head;
+  struct profile_event *e = t->trace + (i & (HC_PROFILE_TRACE_SIZE - 1));
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&e->name, name, __ATOMIC_RELAXED);
+  __atomic_store_n(&e->ticks, ticks, __ATOMIC_RELAXED);
+  __atomic_store_n(&t->head, i + 1, __ATOMIC_RELEASE);
+}
+
+size_t hc_profile_enter(const char *name) {
+  struct profile_thread *t = profile_thread();
+
+  if (t->depth < HC_PROFILE_DEPTH_MAX) {
+    struct hc_profile_node *p =
+      t->depth ? t->zones[t->depth - 1].node : &t->tree.root;
+
+    struct hc_profile_node *n = NULL, *prev = NULL;
+
+    // Names are compared by reference, duplicates are merged when the
+    // profile is collected.
+    for (n = p->child; n && n->name != name; prev = n, n = n->next);
+
+    if (!n) {
+      n = node_new(&t->tree);
+      n->name = name;
+      node_link(p, prev, n);
+    }
+
+    t->zones[t->depth].node = n;
+  }
+
+  const uint64_t ticks = profile_ticks();
+  if (t->depth < HC_PROFILE_DEPTH_MAX) { t->zones[t->depth].start = ticks; }
+  profile_trace(t, name, ticks);
+  return t->depth++;
+}
+
+void hc_profile_exit() {
+  const uint64_t ticks = profile_ticks();
+  struct profile_thread *t = profile_thread();
+  if (!t->depth) { return; }
+  t->depth--;
+  profile_trace(t, NULL, ticks);
+  
+  if (t->depth < HC_PROFILE_DEPTH_MAX) {
+    const struct profile_zone *z = t->zones + t->depth;
+    struct hc_profile_node *n = z->node;
+    __atomic_store_n(&n->count, n->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&n->total, n->total + ticks - z->start, __ATOMIC_RELAXED);
+  }
+}
+
+// Closes any zones left open inside the current one as well, which
+// happens when a throw skips their exits.
+void hc_profile_close(const size_t *depth) {
+  const struct profile_thread *t = profile_current;
+  while (t && t->depth > *depth) { hc_profile_exit(); }
+}
+
+void hc_profile_clear() {
+  pthread_mutex_lock(&profile_lock);
+  __atomic_store_n(&profile_generation, profile_generation + 1,
+		   __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&profile_lock);
+  if (profile_current) { profile_reset(profile_current); }
+}
+
+static void profile_merge(struct hc_profile *p,
+			  struct hc_profile_node *dst,
+			  const struct hc_profile_node *src) {
+  for (const struct hc_profile_node *c =
+	 __atomic_load_n(&src->child, __ATOMIC_ACQUIRE);
+       c;
+       c = __atomic_load_n(&c->next, __ATOMIC_ACQUIRE)) {
+    struct hc_profile_node *n = node_child(p, dst, c->name);
+    n->count += __atomic_load_n(&c->count, __ATOMIC_RELAXED);
+    n->total += profile_span(__atomic_load_n(&c->total, __ATOMIC_RELAXED));
+    profile_merge(p, n, c);
+  }
+}
+
+struct hc_profile *hc_profile_init(struct hc_profile *p) {
+  profile_tree_init(p);
+  pthread_mutex_lock(&profile_lock);
+  
+  // Threads that haven't started over since the last clear are skipped.
+  hc_list_do(&profile_threads, i) {
+    struct profile_thread *t = hc_baseof(i, struct profile_thread, list);
+
+    if (t->generation == profile_generation) {
+      profile_merge(p, &p->root, &t->tree.root);
+    }
+  }
+
+  pthread_mutex_unlock(&profile_lock);
+  node_finish(&p->root);
+  return p;
+}
+
+void hc_profile_deinit(struct hc_profile *p) {
+  for (struct hc_list *i; (i = hc_list_pop_front(&p->blocks));) {
+    free(hc_baseof(i, struct profile_block, list));
+  }
+}
+
+const struct hc_profile_node *
+hc_profile_find(const struct hc_profile_node *n, const char *name) {
+  for (const struct hc_profile_node *c = n->child; c; c = c->next) {
+    if (strcmp(c->name, name) == 0) { return c; }
+  }
+
+  return NULL;
+}
+
+static void folded_path(const struct hc_profile_node *n,
+			struct hc_stream *out) {
+  if (n->parent->parent) {
+    folded_path(n->parent, out);
+    hc_putc(out, ';');
+  }
+  
+  hc_puts(out, n->name);
+}
+
+static void folded_node(const struct hc_profile_node *n,
+			struct hc_stream *out) {
+  if (n->self) {
+    folded_path(n, out);
+    hc_printf(out, " %" PRIu64 "\n", n->self);
+  }
+
+  for (const struct hc_profile_node *c = n->child; c; c = c->next) {
+    folded_node(c, out);
+  }
+}
+
+void hc_profile_folded(const struct hc_profile *p, struct hc_stream *out) {
+  for (const struct hc_profile_node *c = p->root.child; c; c = c->next) {
+    folded_node(c, out);
+  }
+}
+
+static void trace_string(struct hc_stream *out, const char *s) {
+  hc_putc(out, '"');
+
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') {
+      hc_putc(out, '\\');
+      hc_putc(out, *s);
+    } else if ((unsigned char)*s < 0x20) {
+      hc_printf(out, "\\u%04x", *s);
+    } else {
+      hc_putc(out, *s);
+    }
+  }
+
+  hc_putc(out, '"');
+}
+
+// Copies the events that are still in the ring, anything the owner may
+// have overwritten while copying is dropped.
+
+static struct profile_event *
+profile_events(struct profile_thread *t,
+	       struct profile_event *out,
+	       size_t *n) {
+  const size_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+  size_t start = (head > HC_PROFILE_TRACE_SIZE)
+    ? head - HC_PROFILE_TRACE_SIZE
+    : 0;
+
+  for (size_t i = start; i < head; i++) {
+    const struct profile_event *e =
+      t->trace + (i & (HC_PROFILE_TRACE_SIZE - 1));
+
+    out[i - start] = (struct profile_event){
+      .name = __atomic_load_n(&e->name, __ATOMIC_RELAXED),
+      .ticks = __atomic_load_n(&e->ticks, __ATOMIC_RELAXED)
+    };
+  }
+
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  const size_t now = __atomic_load_n(&t->head, __ATOMIC_RELAXED);
+  const size_t skip = (now >= start + HC_PROFILE_TRACE_SIZE)
+    ? hc_min(now - start - HC_PROFILE_TRACE_SIZE + 1, head - start)
+    : 0;
+
+  *n = head - start - skip;
+  return out + skip;
+}
+
+void hc_profile_trace(struct hc_stream *out) {
+  // Shared by collecting threads, protected by profile_lock.
+  static struct profile_event buffer[HC_PROFILE_TRACE_SIZE];
+  hc_puts(out, "{\"traceEvents\":[");
+  pthread_mutex_lock(&profile_lock);
+  hc_ns_t origin = UINT64_MAX;
+
+  // Timestamps are relative to the first event still in the trace.
+  hc_list_do(&profile_threads, i) {
+    struct profile_thread *t = hc_baseof(i, struct profile_thread, list);
+    if (t->generation != profile_generation) { continue; }
+    size_t length;
+    const struct profile_event *es = profile_events(t, buffer, &length);
+    if (length) { origin = hc_min(origin, profile_ns(es->ticks)); }
+  }
+
+  bool sep = false;
+  
+  hc_list_do(&profile_threads, i) {
+    struct profile_thread *t = hc_baseof(i, struct profile_thread, list);
+    if (t->generation != profile_generation) { continue; }
+    size_t length, depth = 0;
+    const struct profile_event *es = profile_events(t, buffer, &length);
+
+    for (const struct profile_event *e = es; e < es + length; e++) {
+      // Exits from zones entered before the start of the trace are
+      // skipped.
+      if (e->name) {
+	depth++;
+      } else if (depth) {
+	depth--;
+      } else {
+	continue;
+      }
+
+      const hc_ns_t ns = profile_ns(e->ticks) - origin;
+      if (sep) { hc_putc(out, ','); }
+      sep = true;
+	
+      hc_printf(out,
+		"{\"ph\":\"%c\",\"pid\":0,\"tid\":%d,"
+		"\"ts\":%" PRIu64 ".%03" PRIu64,
+		e->name ? 'B' : 'E', t->id, ns / 1000, ns % 1000);
+
+      if (e->name) {
+	hc_puts(out, ",\"name\":");
+	trace_string(out, e->name);
+      }
+	
+      hc_putc(out, '}');
+    }
+  }
+  
+  pthread_mutex_unlock(&profile_lock);
+  hc_puts(out, "]}");
+}
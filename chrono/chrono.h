@@ -1,36 +1,194 @@
-#ifndef HACKTICAL_CHRONO_H
-#define HACKTICAL_CHRONO_H
-
-#include <stdint.h>
-#include <time.h>
-
-#define HC_TIME_FORMAT "%Y-%m-%dT%H:%M:%S"
-
-struct hc_stream;
-
-struct hc_time {
-  struct timespec value;
-};
-
-typedef struct hc_time hc_time_t;
-
-hc_time_t hc_now();
-
-hc_time_t hc_time(int year,
-		       int month,
-		       int day,
-		       int hour,
-		       int minute,
-		       int second);
-
-uint64_t hc_time_ns(const hc_time_t *t);
-void hc_time_print(const hc_time_t *t, const char *m);
-char *hc_time_sprintf(const hc_time_t *t, const char *spec);
-
-void hc_time_printf(const hc_time_t *t,
-		    const char *spec,
-		    struct hc_stream *out);
-
-uint64_t hc_sleep(uint64_t ns);
-
-#endif
+#ifndef HACKTICAL_CHRONO_H
+#define HACKTICAL_CHRONO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "list/list.h"
+#include "macro/macro.h"
+
+#define HC_TIME_FORMAT "%Y-%m-%dT%H:%M:%S"
+#define HC_TIME_LENGTH_MAX 64
+
+struct hc_stream;
+
+struct hc_time {
+  struct timespec value;
+};
+
+typedef struct hc_time hc_time_t;
+
+hc_time_t hc_now();
+
+hc_time_t hc_time(int year,
+		       int month,
+		       int day,
+		       int hour,
+		       int minute,
+		       int second);
+
+uint64_t hc_time_ns(const hc_time_t *t);
+void hc_time_print(const hc_time_t *t, const char *m);
+char *hc_time_sprintf(const hc_time_t *t, const char *spec);
+
+size_t hc_time_format(const hc_time_t *t,
+		      const char *spec,
+		      char *out,
+		      size_t n);
+
+const char *hc_time_parse(const char *in, hc_time_t *out);
+
+void hc_time_printf(const hc_time_t *t,
+		    const char *spec,
+		    struct hc_stream *out);
+
+uint64_t hc_sleep(uint64_t ns);
+
+/* Clock */
+
+typedef uint64_t hc_ns_t;
+
+enum hc_clock_source {
+  HC_CLOCK_MONOTONIC,
+  HC_CLOCK_COARSE,
+  HC_CLOCK_TSC,
+  HC_CLOCK_TSCP
+};
+
+struct hc_clock {
+  enum hc_clock_source source;
+  uint64_t tsc_base, mult;
+  hc_ns_t ns_base;
+};
+
+struct hc_clock *hc_clock_init(struct hc_clock *c,
+			       enum hc_clock_source source);
+
+hc_ns_t hc_clock_now(const struct hc_clock *c);
+struct hc_clock *hc_clock();
+hc_ns_t hc_ns();
+
+/* Histogram */
+
+#define HC_HISTOGRAM_PRECISION 7
+
+struct hc_histogram_opts {
+  int precision;
+};
+
+struct hc_histogram {
+  struct hc_histogram_opts opts;
+  size_t length;
+  uint64_t *counts;
+  uint64_t total, min, max;
+};
+
+#define hc_histogram_init(h, ...)					\
+  _hc_histogram_init(h, (struct hc_histogram_opts){			\
+      .precision = HC_HISTOGRAM_PRECISION,				\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_histogram *_hc_histogram_init(struct hc_histogram *h,
+					struct hc_histogram_opts opts);
+
+void hc_histogram_deinit(struct hc_histogram *h);
+void hc_histogram_record(struct hc_histogram *h, uint64_t value);
+void hc_histogram_merge(struct hc_histogram *dst, const struct hc_histogram *src);
+void hc_histogram_clear(struct hc_histogram *h);
+uint64_t hc_histogram_percentile(const struct hc_histogram *h, double p);
+void hc_histogram_print(const struct hc_histogram *h, struct hc_stream *out);
+
+/* Timers */
+
+#define HC_TIMER_LEVELS 4
+#define HC_TIMER_SLOTS 256
+#define HC_TIMER_RESOLUTION 1000000
+
+struct hc_timer;
+typedef void (*hc_timer_callback)(struct hc_timer *);
+
+struct hc_timer {
+  struct hc_list list;
+  hc_timer_callback callback;
+  uint64_t expires;
+};
+
+struct hc_timer_wheel_opts {
+  hc_ns_t resolution;
+};
+
+struct hc_timer_wheel {
+  struct hc_timer_wheel_opts opts;
+  hc_ns_t origin;
+  uint64_t now;
+  size_t count;
+  struct hc_list slots[HC_TIMER_LEVELS][HC_TIMER_SLOTS];
+};
+
+#define hc_timer_wheel_init(w, ...)					\
+  _hc_timer_wheel_init(w, (struct hc_timer_wheel_opts){			\
+      .resolution = HC_TIMER_RESOLUTION,				\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_timer_wheel *_hc_timer_wheel_init(struct hc_timer_wheel *w,
+					    struct hc_timer_wheel_opts opts);
+
+size_t hc_timer_wheel_advance(struct hc_timer_wheel *w, hc_ns_t now);
+hc_ns_t hc_timer_wheel_next(const struct hc_timer_wheel *w);
+
+struct hc_timer *hc_timer_init(struct hc_timer *t, hc_timer_callback callback);
+bool hc_timer_active(const struct hc_timer *t);
+
+void hc_timer_start(struct hc_timer_wheel *w,
+		    struct hc_timer *t,
+		    hc_ns_t deadline);
+
+void hc_timer_cancel(struct hc_timer_wheel *w, struct hc_timer *t);
+
+/* Profile */
+
+#define HC_PROFILE_BLOCK_SIZE 64
+#define HC_PROFILE_DEPTH_MAX 64
+#define HC_PROFILE_TRACE_SIZE 4096
+
+#define _hc_profile_do(name, _d, _p)					\
+  for (size_t _d __attribute__ ((__cleanup__(hc_profile_close))) =	\
+	 hc_profile_enter(name), _p = 1;				\
+       _p;								\
+       _p = 0)
+
+#define hc_profile_do(name)						\
+  _hc_profile_do(name, hc_unique(profile_d), hc_unique(profile_p))
+
+struct hc_profile_node {
+  const char *name;
+  struct hc_profile_node *parent, *child, *next;
+  uint64_t count;
+  hc_ns_t total, self;
+};
+
+struct hc_profile {
+  struct hc_profile_node root;
+  struct hc_list blocks;
+  size_t block_length;
+};
+
+size_t hc_profile_enter(const char *name);
+void hc_profile_exit();
+void hc_profile_close(const size_t *depth);
+void hc_profile_clear();
+
+struct hc_profile *hc_profile_init(struct hc_profile *p);
+void hc_profile_deinit(struct hc_profile *p);
+
+const struct hc_profile_node *
+hc_profile_find(const struct hc_profile_node *n, const char *name);
+
+void hc_profile_folded(const struct hc_profile *p, struct hc_stream *out);
+void hc_profile_trace(struct hc_stream *out);
+
+#endif
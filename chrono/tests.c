@@ -1,9 +1,285 @@
-#include <assert.h>
-#include "chrono.h"
-
-void chrono_tests() {
-  hc_time_t t = hc_now();
-  const int ns = 1000;
-  assert(hc_sleep(ns) == 0);
-  assert(hc_time_ns(&t) >= ns);
-}
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chrono.h"
+#include "malloc1/malloc1.h"
+#include "stream1/stream1.h"
+
+static void format_tests() {
+  hc_time_t t = hc_time(2025, 4, 13, 1, 40, 5);
+  char buf[HC_TIME_LENGTH_MAX];
+  assert(hc_time_format(&t, HC_TIME_FORMAT, buf, sizeof(buf)) == 19);
+  assert(strcmp(buf, "2025-04-13T01:40:05") == 0);
+
+  // The second call is served from the cache.
+  assert(hc_time_format(&t, HC_TIME_FORMAT, buf, sizeof(buf)) == 19);
+  assert(strcmp(buf, "2025-04-13T01:40:05") == 0);
+  
+  assert(hc_time_format(&t, "%Y/%m/%d", buf, sizeof(buf)) == 10);
+  assert(strcmp(buf, "2025/04/13") == 0);
+  assert(!hc_time_format(&t, HC_TIME_FORMAT, buf, 19));
+
+  hc_time_t midnight = hc_time(2025, 4, 13, 23, 59, 59);
+  hc_time_format(&midnight, HC_TIME_FORMAT, buf, sizeof(buf));
+  midnight.value.tv_sec++;
+  hc_time_format(&midnight, HC_TIME_FORMAT, buf, sizeof(buf));
+  assert(strcmp(buf, "2025-04-14T00:00:00") == 0);
+
+  hc_time_t before = hc_time(1969, 12, 31, 23, 59, 59);
+  hc_time_format(&before, HC_TIME_FORMAT, buf, sizeof(buf));
+  assert(strcmp(buf, "1969-12-31T23:59:59") == 0);
+
+  char *s = hc_time_sprintf(&t, "%H:%M");
+  assert(strcmp(s, "01:40") == 0);
+  free(s);
+}
+
+static void parse_tests() {
+  hc_time_t t;
+  const char *in = "2025-04-13T01:40:05";
+  assert(hc_time_parse(in, &t) == in + strlen(in));
+  assert(t.value.tv_sec == hc_time(2025, 4, 13, 1, 40, 5).value.tv_sec);
+  assert(!t.value.tv_nsec);
+
+  assert(hc_time_parse("2024-02-29 12:00:00.25Z", &t));
+  assert(t.value.tv_sec == hc_time(2024, 2, 29, 12, 0, 0).value.tv_sec);
+  assert(t.value.tv_nsec == 250000000);
+
+  assert(hc_time_parse("2025-04-13T03:40:05+02:00", &t));
+  assert(t.value.tv_sec == hc_time(2025, 4, 13, 1, 40, 5).value.tv_sec);
+  assert(hc_time_parse("2025-04-12T23:40:05-0200", &t));
+  assert(t.value.tv_sec == hc_time(2025, 4, 13, 1, 40, 5).value.tv_sec);
+  
+  assert(!hc_time_parse("2025-02-29T00:00:00", &t));
+  assert(!hc_time_parse("2025-04-13T24:00:00", &t));
+  assert(!hc_time_parse("2025-04-13", &t));
+}
+
+static void clock_tests() {
+  const enum hc_clock_source sources[] = {
+    HC_CLOCK_MONOTONIC, HC_CLOCK_COARSE, HC_CLOCK_TSC, HC_CLOCK_TSCP
+  };
+
+  for (int i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+    struct hc_clock c;
+    hc_clock_init(&c, sources[i]);
+    const hc_ns_t start = hc_clock_now(&c);
+    hc_ns_t prev = start;
+
+    for (int j = 0; j < 1000; j++) {
+      const hc_ns_t now = hc_clock_now(&c);
+      assert(now >= prev);
+      prev = now;
+    }
+
+    hc_sleep(1000000);
+    const hc_ns_t elapsed = hc_clock_now(&c) - start;
+
+    // The coarse clock only ticks every few milliseconds.
+    assert(elapsed >= ((c.source == HC_CLOCK_COARSE) ? 0 : 1000000));
+    assert(elapsed < 1000000000);
+  }
+
+  const hc_ns_t t = hc_ns();
+  assert(hc_ns() >= t);
+}
+
+static void histogram_tests() {
+  struct hc_histogram h;
+  hc_histogram_init(&h);
+  assert(!hc_histogram_percentile(&h, 50));
+  
+  for (uint64_t v = 1; v <= 100000; v++) {
+    hc_histogram_record(&h, v);
+  }
+
+  assert(h.total == 100000 && h.min == 1 && h.max == 100000);
+  const double ps[] = {50, 90, 99, 99.9};
+  
+  for (int i = 0; i < sizeof(ps) / sizeof(ps[0]); i++) {
+    const double expected = ps[i] * 1000;
+    const double actual = hc_histogram_percentile(&h, ps[i]);
+    assert(actual >= expected && actual <= expected * (1 + 1.0 / 64));
+  }
+
+  assert(hc_histogram_percentile(&h, 100) == 100000);
+  hc_histogram_record(&h, UINT64_MAX);
+  assert(hc_histogram_percentile(&h, 100) == UINT64_MAX);
+  
+  struct hc_histogram sum;
+  hc_histogram_init(&sum);
+  hc_histogram_merge(&sum, &h);
+  hc_histogram_merge(&sum, &h);
+  assert(sum.total == 2 * h.total && sum.min == 1 && sum.max == UINT64_MAX);
+  assert(hc_histogram_percentile(&sum, 50) == hc_histogram_percentile(&h, 50));
+  
+  hc_histogram_clear(&h);
+  hc_histogram_record(&h, 42);
+  
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_histogram_print(&h, &out.stream);
+  
+  assert(strcmp(hc_memory_stream_string(&out),
+		"n=1 min=42 p50=42 p90=42 p99=42 p999=42 max=42") == 0);
+
+  hc_stream_deinit(&out.stream);
+  hc_histogram_deinit(&sum);
+  hc_histogram_deinit(&h);
+}
+
+struct test_timer {
+  struct hc_timer timer;
+  hc_ns_t fired;
+};
+
+static hc_ns_t timer_now = 0;
+
+static void timer_fire(struct hc_timer *t) {
+  hc_baseof(t, struct test_timer, timer)->fired = timer_now;
+}
+
+static void timer_tests() {
+  struct hc_timer_wheel w;
+  hc_timer_wheel_init(&w, .resolution = 1);
+  assert(!hc_timer_wheel_next(&w));
+
+  // Covers every level as well as timers beyond the range of the wheel.
+  const hc_ns_t deadlines[] = {1, 255, 256, 1000, 65536, 70000,
+			       1 << 24, (1ULL << 32) + 3};
+  const int n = sizeof(deadlines) / sizeof(deadlines[0]);
+  struct test_timer ts[n];
+
+  for (int i = 0; i < n; i++) {
+    hc_timer_init(&ts[i].timer, timer_fire);
+    ts[i].fired = 0;
+    hc_timer_start(&w, &ts[i].timer, w.origin + deadlines[i]);
+    assert(hc_timer_active(&ts[i].timer));
+  }
+
+  struct test_timer canceled;
+  hc_timer_init(&canceled.timer, timer_fire);
+  canceled.fired = 0;
+  hc_timer_start(&w, &canceled.timer, w.origin + 500);
+  hc_timer_cancel(&w, &canceled.timer);
+  assert(!hc_timer_active(&canceled.timer));
+  assert(hc_timer_wheel_next(&w) == w.origin + 1);
+
+  // Steps straight to each deadline, all ticks in between are processed.
+  for (int i = 0; i < n; i++) {
+    timer_now = deadlines[i];
+    assert(hc_timer_wheel_advance(&w, w.origin + timer_now) == 1);
+    assert(ts[i].fired == deadlines[i]);
+    assert(!hc_timer_active(&ts[i].timer));
+  }
+
+  assert(!canceled.fired);
+  assert(!w.count);
+
+  // Timers behind the current slot belong to the next turn of the first
+  // level and may not be skipped along with the empty levels above.
+  const hc_ns_t start = timer_now + HC_TIMER_SLOTS - 9;
+  hc_timer_wheel_advance(&w, w.origin + start);
+  struct test_timer wrapped;
+  hc_timer_init(&wrapped.timer, timer_fire);
+  wrapped.fired = 0;
+  hc_timer_start(&w, &wrapped.timer, w.origin + start + 10);
+  timer_now = start + 10;
+  assert(!hc_timer_wheel_advance(&w, w.origin + start + 9));
+  assert(hc_timer_wheel_advance(&w, w.origin + start + 10) == 1);
+  assert(wrapped.fired == start + 10);
+}
+
+static int profile_return() {
+  hc_profile_do("return") {
+    return 42;
+  }
+
+  return 0;
+}
+
+static void profile_tests() {
+  hc_profile_clear();
+
+  for (int i = 0; i < 3; i++) {
+    hc_profile_do("outer") {
+      hc_profile_do("inner") {
+	hc_sleep(1000);
+      }
+
+      hc_profile_do("other") {}
+    }
+  }
+
+  // Leaving the block early closes the zone.
+  assert(profile_return() == 42);
+
+  hc_profile_do("break") {
+    break;
+  }
+
+  // Left open, not counted.
+  hc_profile_enter("open");
+
+  struct hc_profile p;
+  hc_profile_init(&p);
+  const struct hc_profile_node *outer = hc_profile_find(&p.root, "outer");
+  assert(outer && outer->count == 3);
+  assert(!hc_profile_find(&p.root, "open")->count);
+  const struct hc_profile_node *ret = hc_profile_find(&p.root, "return");
+  assert(ret && ret->count == 1);
+  const struct hc_profile_node *brk = hc_profile_find(&p.root, "break");
+  assert(brk && brk->count == 1);
+  
+  const struct hc_profile_node *inner = hc_profile_find(outer, "inner");
+  assert(inner && inner->count == 3 && inner->total >= 3000);
+  assert(hc_profile_find(outer, "other")->count == 3);
+  assert(outer->total >= inner->total);
+  assert(p.root.total == outer->total + ret->total + brk->total);
+  
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_profile_folded(&p, &out.stream);
+  assert(strstr(hc_memory_stream_string(&out), "outer;inner "));
+  hc_stream_deinit(&out.stream);
+  hc_profile_deinit(&p);
+
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_profile_trace(&out.stream);
+  const char *trace = hc_memory_stream_string(&out);
+  assert(strncmp(trace, "{\"traceEvents\":[{\"ph\":\"B\"", 25) == 0);
+  assert(strstr(trace, "\"name\":\"inner\""));
+  assert(strcmp(trace + strlen(trace) - 2, "]}") == 0);
+  hc_stream_deinit(&out.stream);
+
+  // Zones are counted as they exit, long after their events have been
+  // dropped from the trace.
+  for (int i = 0; i < HC_PROFILE_TRACE_SIZE; i++) {
+    hc_profile_do("many") {}
+  }
+
+  hc_profile_init(&p);
+  const struct hc_profile_node *many = hc_profile_find(&p.root, "open");
+  many = hc_profile_find(many, "many");
+  assert(many && many->count == HC_PROFILE_TRACE_SIZE);
+  hc_profile_deinit(&p);
+
+  hc_profile_exit();
+  hc_profile_clear();
+  hc_profile_init(&p);
+  assert(!p.root.child);
+  hc_profile_deinit(&p);
+}
+
+void chrono_tests() {
+  hc_time_t t = hc_now();
+  const int ns = 1000;
+  assert(hc_sleep(ns) == 0);
+  assert(hc_time_ns(&t) >= ns);
+  format_tests();
+  parse_tests();
+  clock_tests();
+  histogram_tests();
+  timer_tests();
+  profile_tests();
+}
@@ -1,59 +1,71 @@
-#include <assert.h>
-#include <inttypes.h>
-#include <stdio.h>
-#include "fix.h"
-
-static void test_add() {
-  assert(hc_fix_add(hc_fix(2, 175), hc_fix(2, 25)) ==
-	 hc_fix(2, 200));
-    
-  assert(hc_fix_add(hc_fix(2, 175), hc_fix(2, -25)) ==
-	 hc_fix(2, 150));
-}
-
-static void test_div() {
-  assert(hc_fix_div(hc_fix(2, 150), hc_fix(0, 2)) ==
-	 hc_fix(2, 75));
-
-  assert(hc_fix_div(hc_fix(2, 150), hc_fix(0, -2)) ==
-	 hc_fix(2, -75));
-
-  assert(hc_fix_div(hc_fix(2, -150), hc_fix(0, -2)) ==
-	 hc_fix(2, 75));
-}
-
-static void test_mul() {
-  assert(hc_fix_mul(hc_fix(2, 150), hc_fix(1, 5)) ==
-	 hc_fix(2, 75));
-
-  assert(hc_fix_mul(hc_fix(2, 150), hc_fix(1, -5)) ==
-	 hc_fix(2, -75));
-
-  assert(hc_fix_mul(hc_fix(2, -150), hc_fix(1, -5)) ==
-	 hc_fix(2, 75));
-}
-
-static void test_new() {
-  hc_fix_t x = hc_fix(2, -125);
-  assert(hc_fix_exp(x) == 2);
-  assert(hc_fix_val(x) == -125);
-  assert(hc_fix_int(x) == -1);
-  assert(hc_fix_frac(x) == -25);
-  assert(hc_fix_double(x) == -1.25);
-}
-
-static void test_sub() {
-  assert(hc_fix_sub(hc_fix(2, 175), hc_fix(2, 25)) ==
-	 hc_fix(2, 150));
-
-  assert(hc_fix_sub(hc_fix(2, 175), hc_fix(2, -25)) ==
-	 hc_fix(2, 200));
-}
-
-void fix_tests() {
-  test_add();
-  test_div();
-  test_mul();
-  test_new();
-  test_sub();
-}
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "fix.h"
+#include "malloc1/malloc1.h"
+#include "stream1/stream1.h"
+
+static void test_add() {
+  assert(hc_fix_add(hc_fix(2, 175), hc_fix(2, 25)) ==
+	 hc_fix(2, 200));
+    
+  assert(hc_fix_add(hc_fix(2, 175), hc_fix(2, -25)) ==
+	 hc_fix(2, 150));
+}
+
+static void test_div() {
+  assert(hc_fix_div(hc_fix(2, 150), hc_fix(0, 2)) ==
+	 hc_fix(2, 75));
+
+  assert(hc_fix_div(hc_fix(2, 150), hc_fix(0, -2)) ==
+	 hc_fix(2, -75));
+
+  assert(hc_fix_div(hc_fix(2, -150), hc_fix(0, -2)) ==
+	 hc_fix(2, 75));
+}
+
+static void test_mul() {
+  assert(hc_fix_mul(hc_fix(2, 150), hc_fix(1, 5)) ==
+	 hc_fix(2, 75));
+
+  assert(hc_fix_mul(hc_fix(2, 150), hc_fix(1, -5)) ==
+	 hc_fix(2, -75));
+
+  assert(hc_fix_mul(hc_fix(2, -150), hc_fix(1, -5)) ==
+	 hc_fix(2, 75));
+}
+
+static void test_new() {
+  hc_fix_t x = hc_fix(2, -125);
+  assert(hc_fix_exp(x) == 2);
+  assert(hc_fix_val(x) == -125);
+  assert(hc_fix_int(x) == -1);
+  assert(hc_fix_frac(x) == -25);
+  assert(hc_fix_double(x) == -1.25);
+}
+
+static void test_print() {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&s.stream));
+  hc_fix_print(hc_fix(2, -125), &s.stream);
+  assert(strcmp("-1.25", hc_memory_stream_string(&s)) == 0);
+}
+
+static void test_sub() {
+  assert(hc_fix_sub(hc_fix(2, 175), hc_fix(2, 25)) ==
+	 hc_fix(2, 150));
+
+  assert(hc_fix_sub(hc_fix(2, 175), hc_fix(2, -25)) ==
+	 hc_fix(2, 200));
+}
+
+void fix_tests() {
+  test_add();
+  test_div();
+  test_mul();
+  test_new();
+  test_print();
+  test_sub();
+}
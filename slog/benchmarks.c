@@ -0,0 +1,144 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "chrono/chrono.h"
+#include "slog.h"
+
+#define SLOG_LINES 100000
+
+static void slog_report(const hc_time_t *t,
+			const char *name,
+			const int fields) {
+  const uint64_t ns = hc_time_ns(t);
+  printf("%s: %" PRIu64 "ns %.1fMlines/s %.1fMfields/s\n",
+	 name, ns, SLOG_LINES * 1000.0 / ns, SLOG_LINES * fields * 1000.0 / ns);
+}
+
+static void slog_run(struct hc_slog *s, const char *name) {
+  _hc_slog_do(s) {
+    hc_time_t t = hc_now();
+
+    for (int i = 0; i < SLOG_LINES; i++) {
+      hc_slog_write(hc_slog_string_ref("level", "info"),
+		    hc_slog_string_ref("msg", "request done"),
+		    hc_slog_string_ref("method", "GET"),
+		    hc_slog_string_ref("path", "/index.html"),
+		    hc_slog_int_ref("status", 200),
+		    hc_slog_int_ref("bytes", 4096),
+		    hc_slog_int_ref("id", i),
+		    hc_slog_bool_ref("cached", true),
+		    hc_slog_bool_ref("tls", false),
+		    hc_slog_time_ref("time", t));
+    }
+
+    slog_report(&t, name, 10);
+  }
+}
+
+void slog_benchmarks() {
+  FILE *f = fopen("/dev/null", "w");
+  struct hc_file_stream out;
+  hc_file_stream_init(&out, f, .close_file = true);
+  
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream);
+
+  hc_slog_do(&s) {
+    hc_time_t t = hc_now();
+    
+    for (int i = 0; i < SLOG_LINES; i++) {
+      hc_slog_write(hc_slog_string("level", "info"),
+		    hc_slog_string("msg", "request done"),
+		    hc_slog_string("method", "GET"),
+		    hc_slog_string("path", "/index.html"),
+		    hc_slog_int("status", 200),
+		    hc_slog_int("bytes", 4096),
+		    hc_slog_int("id", i),
+		    hc_slog_bool("cached", true),
+		    hc_slog_bool("tls", false),
+		    hc_slog_int("worker", 7));
+    }
+
+    slog_report(&t, "allocated", 10);
+    t = hc_now();
+    
+    for (int i = 0; i < SLOG_LINES; i++) {
+      hc_slog_write(hc_slog_string_ref("level", "info"),
+		    hc_slog_string_ref("msg", "request done"),
+		    hc_slog_string_ref("method", "GET"),
+		    hc_slog_string_ref("path", "/index.html"),
+		    hc_slog_int_ref("status", 200),
+		    hc_slog_int_ref("bytes", 4096),
+		    hc_slog_int_ref("id", i),
+		    hc_slog_bool_ref("cached", true),
+		    hc_slog_bool_ref("tls", false),
+		    hc_slog_int_ref("worker", 7));
+    }
+
+    slog_report(&t, "borrowed", 10);
+  }
+
+  hc_slog_do(&s) {
+    hc_time_t t = hc_now();
+    
+    for (int i = 0; i < SLOG_LINES; i++) {
+      hc_slog_debug(hc_slog_string("level", "debug"),
+		    hc_slog_string("msg", "request done"),
+		    hc_slog_int("id", i));
+    }
+
+    slog_report(&t, "disabled", 3);
+  }
+
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_string_ref("service", "api"),
+		       hc_slog_string_ref("host", "web-1"),
+		       hc_slog_string_ref("method", "GET"),
+		       hc_slog_string_ref("path", "/index.html"),
+		       hc_slog_string_ref("client", "10.0.0.1"),
+		       hc_slog_int_ref("request", 1234),
+		       hc_slog_int_ref("worker", 7),
+		       hc_slog_bool_ref("tls", true)) {
+      hc_time_t t = hc_now();
+    
+      for (int i = 0; i < SLOG_LINES; i++) {
+	hc_slog_write(hc_slog_string_ref("msg", "step"),
+		      hc_slog_int_ref("i", i));
+      }
+
+      slog_report(&t, "context", 10);
+    }
+  }
+  
+  slog_run(&s.slog, "text");
+  hc_slog_deinit(&s);
+
+  struct hc_slog_binary b;
+  hc_slog_binary_init(&b, &out.stream, .close_out = true);
+  slog_run(&b.slog, "binary");
+  hc_slog_deinit(&b);
+
+  f = fopen("/dev/null", "w");
+  hc_file_stream_init(&out, f, .close_file = true);
+  struct hc_slog_json j;
+  hc_slog_json_init(&j, &out.stream, .close_out = true);
+  slog_run(&j.slog, "json");
+  hc_slog_deinit(&j);
+
+  char path[] = "/tmp/hc_slog_bench_XXXXXX";
+  close(mkstemp(path));
+  struct hc_slog_file fs;
+  hc_slog_file_init(&fs, path, .max_size = 16 * 1024 * 1024);
+  slog_run(&fs.slog, "file");
+  hc_slog_deinit(&fs);
+  
+  for (int i = 1; i <= fs.opts.keep; i++) {
+    char rotated[sizeof(path) + 8];
+    snprintf(rotated, sizeof(rotated), "%s.%d", path, i);
+    unlink(rotated);
+  }
+  
+  unlink(path);
+}
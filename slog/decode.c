@@ -0,0 +1,13 @@
+#include "error/error.h"
+#include "slog.h"
+
+// Converts binary logs on stdin to text on stdout.
+
+int main() {
+  struct hc_file_stream in;
+  hc_file_stream_init(&in, stdin);
+  hc_slog_binary_decode(&in.stream, hc_stdout());
+  hc_stream_deinit(&in.stream);
+  hc_errors_deinit();
+  return 0;
+}
@@ -1,159 +1,1303 @@
-#include <assert.h>
-#include <stdarg.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "error/error.h"
-#include "macro/macro.h"
-#include "malloc1/malloc1.h"
-#include "slog.h"
-
-__thread struct hc_slog *_hc_slog = NULL;
-
-struct hc_slog *hc_slog() {
-  if (_hc_slog != NULL) {
-    return _hc_slog;
-  }
-  
-  static __thread bool init = true;
-  static __thread struct hc_slog_stream s;
-
-  if (init) {
-    hc_slog_stream_init(&s, hc_stdout());
-    init = false;
-  }
-
-  return &s.slog;
-}
-
-static void field_deinit(struct hc_slog_field *f) {
-  free(f->name);
-  hc_value_deinit(&f->value);
-}
-
-static void slog_write(struct hc_slog *s,
-		       const size_t n,
-		       struct hc_slog_field *fields[]) {
-  assert(s->write);
-  s->write(s, n, fields);
-}
-
-void __hc_slog_write(struct hc_slog *s,
-		     const size_t n,
-		     struct hc_slog_field *fields[]) {
-  slog_write(s, n, fields);
-  
-  for(size_t i = 0; i < n; i++) {
-    struct hc_slog_field *f = fields[i];
-    field_deinit(f);
-    free(f);
-  }
-}
-
-void _hc_slog_deinit(struct hc_slog *s) {
-  if (s->deinit) {
-    s->deinit(s);
-  }
-}
-
-static struct hc_value *field_init(struct hc_slog_field *f,
-				   const char *name,
-				   const struct hc_type *type) {
-  f->name = strdup(name);
-  hc_value_init(&f->value, type);
-  return &f->value;
-}
-
-struct hc_slog_field *hc_slog_bool(const char *name, const bool value) {
-  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
-  field_init(f, name, &HC_BOOL)->as_bool = value;
-  return f;
-}
-
-struct hc_slog_field *hc_slog_int(const char *name, const int value) {
-  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
-  field_init(f, name, &HC_INT)->as_int = value;
-  return f;
-}
-
-struct hc_slog_field *hc_slog_string(const char *name, const char *value) {
-  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
-  field_init(f, name, &HC_STRING)->as_string = strdup(value);
-  return f;
-}
-
-struct hc_slog_field *hc_slog_time(const char *name, const hc_time_t value) {
-  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
-  field_init(f, name, &HC_TIME)->as_time = value;
-  return f;
-}
-
-void stream_deinit(struct hc_slog *s) {
-  struct hc_slog_stream *ss = hc_baseof(s, struct hc_slog_stream, slog);
-  if (ss->opts.close_out) { hc_stream_deinit(ss->out); }
-}
-
-static void field_write(struct hc_slog_field *f, struct hc_stream *out) {
-  hc_puts(out, f->name);
-  hc_putc(out, '=');
-  hc_value_write(&f->value, out);
-}
-
-static void stream_write(struct hc_slog *s,
-			 const size_t n,
-			 struct hc_slog_field *fields[]) {
-  struct hc_slog_stream *ss = hc_baseof(s, struct hc_slog_stream, slog);
-
-  for(size_t i = 0; i < n; i++) {
-    struct hc_slog_field *f = fields[i];
-    if (i) { hc_puts(ss->out, ", "); }
-    field_write(f, ss->out);
-  }
-
-  hc_putc(ss->out, '\n');
-}
-
-struct hc_slog_stream *_hc_slog_stream_init(struct hc_slog_stream *s,
-					    struct hc_stream *out,
-					    const struct hc_slog_stream_opts opts) {
-  s->slog.deinit = stream_deinit;
-  s->slog.write = stream_write;
-  s->out = out;
-  s->opts = opts;
-  return s;
-}
-
-static void context_deinit(struct hc_slog *s) {
-  struct hc_slog_context *sc = hc_baseof(s, struct hc_slog_context, slog);
-
-  for (size_t i = 0; i < sc->length; i++) {
-    struct hc_slog_field *f = sc->fields[i];
-    field_deinit(f);
-    free(f);
-  }
-
-  free(sc->fields);
-}
-
-static void context_write(struct hc_slog *s,
-			  const size_t n,
-			  struct hc_slog_field *fields[]) {
-  struct hc_slog_context *c = hc_baseof(s, struct hc_slog_context, slog);
-  struct hc_slog_field *fs[c->length + n];
-  memcpy(fs, c->fields, sizeof(struct hc_slog_field *) * c->length);
-  memcpy(fs + c->length, fields, sizeof(struct hc_slog_field *) * n);
-  slog_write(c->parent, c->length + n, fs);
-}
-
-struct hc_slog_context *hc_slog_context_init(struct hc_slog_context *c,
-					     size_t length,
-					     struct hc_slog_field *fields[]) {
-  c->slog.deinit = context_deinit;
-  c->slog.write = context_write;
-  c->parent = hc_slog();
-  c->length = length;
-  size_t s = sizeof(struct hc_slog_field *) * length;
-  c->fields = malloc(s);
-  memcpy(c->fields, fields, s);
-  return c;
-}
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "error/error.h"
+#include "macro/macro.h"
+#include "malloc1/malloc1.h"
+#include "slog.h"
+
+__thread struct hc_slog *_hc_slog = NULL;
+
+struct hc_slog *hc_slog() {
+  if (_hc_slog != NULL) {
+    return _hc_slog;
+  }
+  
+  static __thread bool init = true;
+  static __thread struct hc_slog_stream s;
+
+  if (init) {
+    hc_slog_stream_init(&s, hc_stdout());
+    init = false;
+  }
+
+  return &s.slog;
+}
+
+static void field_free(struct hc_slog_field *f) {
+  if (!f->borrowed) {
+    free(f->name);
+    hc_value_deinit(&f->value);
+    free(f);
+  }
+}
+
+static void slog_write(struct hc_slog *s,
+		       const size_t n,
+		       struct hc_slog_field *fields[]) {
+  assert(s->write);
+  s->write(s, n, fields);
+}
+
+void __hc_slog_write(struct hc_slog *s,
+		     const size_t n,
+		     struct hc_slog_field *fields[]) {
+  for (size_t i = 0; i < n; i++) {
+    struct hc_slog_field *f = fields[i];
+    if (f->lazy) { f->lazy(&f->value, f->lazy_arg); }
+  }
+  
+  slog_write(s, n, fields);
+  
+  for(size_t i = 0; i < n; i++) {
+    struct hc_slog_field *f = fields[i];
+    if (f->lazy) { hc_value_deinit(&f->value); }
+    field_free(f);
+  }
+}
+
+void _hc_slog_deinit(struct hc_slog *s) {
+  if (s->deinit) {
+    s->deinit(s);
+  }
+}
+
+static struct hc_value *field_init(struct hc_slog_field *f,
+				   const char *name,
+				   const struct hc_type *type) {
+  f->name = strdup(name);
+  f->borrowed = false;
+  f->lazy = NULL;
+  hc_value_init(&f->value, type);
+  return &f->value;
+}
+
+struct hc_slog_field *hc_slog_bool(const char *name, const bool value) {
+  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
+  field_init(f, name, &HC_BOOL)->as_bool = value;
+  return f;
+}
+
+struct hc_slog_field *hc_slog_int(const char *name, const int value) {
+  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
+  field_init(f, name, &HC_INT)->as_int = value;
+  return f;
+}
+
+struct hc_slog_field *hc_slog_string(const char *name, const char *value) {
+  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
+  field_init(f, name, &HC_STRING)->as_string = strdup(value);
+  return f;
+}
+
+struct hc_slog_field *hc_slog_time(const char *name, const hc_time_t value) {
+  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
+  field_init(f, name, &HC_TIME)->as_time = value;
+  return f;
+}
+
+struct hc_slog_field *hc_slog_uint(const char *name, const uint64_t value) {
+  struct hc_slog_field *f = malloc(sizeof(struct hc_slog_field));
+  field_init(f, name, &HC_UINT)->as_uint = value;
+  return f;
+}
+
+void hc_slog_histogram(const char *name, const struct hc_histogram *h) {
+  hc_slog_write(hc_slog_string_ref("histogram", name),
+		hc_slog_uint_ref("n", h->total),
+		hc_slog_uint_ref("min", h->total ? h->min : 0),
+		hc_slog_uint_ref("p50", hc_histogram_percentile(h, 50)),
+		hc_slog_uint_ref("p90", hc_histogram_percentile(h, 90)),
+		hc_slog_uint_ref("p99", hc_histogram_percentile(h, 99)),
+		hc_slog_uint_ref("p999", hc_histogram_percentile(h, 99.9)),
+		hc_slog_uint_ref("max", h->max));
+}
+
+void stream_deinit(struct hc_slog *s) {
+  struct hc_slog_stream *ss = hc_baseof(s, struct hc_slog_stream, slog);
+  if (ss->opts.close_out) { hc_stream_deinit(ss->out); }
+}
+
+static void field_write(struct hc_slog_field *f, struct hc_stream *out) {
+  hc_puts(out, f->name);
+  hc_putc(out, '=');
+  hc_value_write(&f->value, out);
+}
+
+static void stream_render(struct hc_slog *s,
+			  struct hc_memory_stream *prefix,
+			  const size_t n,
+			  struct hc_slog_field *fields[]) {
+  for(size_t i = 0; i < n; i++) {
+    if (prefix->data.length) { hc_puts(&prefix->stream, ", "); }
+    field_write(fields[i], &prefix->stream);
+  }
+}
+
+static void stream_write_prefixed(struct hc_slog *s,
+				  const uint8_t *prefix,
+				  const size_t prefix_length,
+				  const size_t n,
+				  struct hc_slog_field *fields[]) {
+  struct hc_slog_stream *ss = hc_baseof(s, struct hc_slog_stream, slog);
+  if (prefix_length) { hc_write(ss->out, prefix, prefix_length); }
+  
+  for(size_t i = 0; i < n; i++) {
+    struct hc_slog_field *f = fields[i];
+    if (i || prefix_length) { hc_puts(ss->out, ", "); }
+    field_write(f, ss->out);
+  }
+
+  hc_putc(ss->out, '\n');
+}
+
+static void stream_write(struct hc_slog *s,
+			 const size_t n,
+			 struct hc_slog_field *fields[]) {
+  stream_write_prefixed(s, NULL, 0, n, fields);
+}
+
+struct hc_slog_stream *_hc_slog_stream_init(struct hc_slog_stream *s,
+					    struct hc_stream *out,
+					    const struct hc_slog_stream_opts opts) {
+  s->slog = (struct hc_slog){
+    .deinit = stream_deinit,
+    .write = stream_write,
+    .render = stream_render,
+    .write_prefixed = stream_write_prefixed,
+    .level = HC_SLOG_INFO
+  };
+
+  s->out = out;
+  s->opts = opts;
+  return s;
+}
+
+enum binary_tag {
+  BINARY_BOOL, BINARY_FIX, BINARY_INT, BINARY_STRING, BINARY_TIME,
+  BINARY_UINT
+};
+
+struct binary_name {
+  char *name;
+  size_t id;
+};
+
+static const void *binary_name_key(const void *x) {
+  return ((const struct binary_name *)x)->name;
+}
+
+static enum hc_order name_cmp(const void *x, const void *y) {
+  const int result = strcmp(x, y);
+  return (result < 0) ? HC_LT : ((result > 0) ? HC_GT : HC_EQ);
+}
+
+static uint8_t *put_varint(uint8_t *p, uint64_t v) {
+  for (; v >= 0x80; v >>= 7) {
+    *p++ = (v & 0x7f) | 0x80;
+  }
+
+  *p++ = v;
+  return p;
+}
+
+static uint8_t *put_bytes(uint8_t *p, const char *data, const size_t n) {
+  p = put_varint(p, n);
+  memcpy(p, data, n);
+  return p + n;
+}
+
+static void binary_deinit(struct hc_slog *s) {
+  struct hc_slog_binary *sb = hc_baseof(s, struct hc_slog_binary, slog);
+
+  hc_vector_do(&sb->names.items, n) {
+    free(((struct binary_name *)n)->name);
+  }
+  
+  hc_set_deinit(&sb->names);
+  hc_vector_deinit(&sb->buffer);
+  if (sb->opts.close_out) { hc_stream_deinit(sb->out); }
+}
+
+static uint8_t *binary_name_write(struct hc_slog_binary *s,
+				  uint8_t *p,
+				  const char *name,
+				  const size_t n) {
+  struct binary_name *bn = hc_set_find(&s->names, name);
+
+  if (bn) {
+    return put_varint(p, bn->id);
+  }
+
+  // New names are written in full once and referred to by id after that.
+  const size_t id = hc_set_length(&s->names) + 1;
+  bn = hc_set_add(&s->names, name, false);
+  *bn = (struct binary_name){.name = strdup(name), .id = id};
+  return put_bytes(put_varint(p, 0), name, n);
+}
+
+// Upper bound of a varint, a type tag and a varint length.
+#define BINARY_OVERHEAD 21
+
+static void binary_write(struct hc_slog *s,
+			 const size_t n,
+			 struct hc_slog_field *fields[]) {
+  struct hc_slog_binary *sb = hc_baseof(s, struct hc_slog_binary, slog);
+  size_t lengths[n * 2], size = 2 * BINARY_OVERHEAD;
+
+  // The record is encoded in one go, which needs an upper bound for its size.
+  for (size_t i = 0; i < n; i++) {
+    const struct hc_slog_field *f = fields[i];
+    lengths[i * 2] = strlen(f->name) + 1;
+
+    lengths[i * 2 + 1] = (f->value.type == &HC_STRING)
+      ? strlen(f->value.as_string) + 1
+      : sizeof(hc_time_t);
+    
+    size += lengths[i * 2] + lengths[i * 2 + 1] + 2 * BINARY_OVERHEAD;
+  }
+
+  if (size > sb->buffer.capacity) { hc_vector_grow(&sb->buffer, size); }
+
+  // Leaves room in front for the record length.
+  uint8_t *const start = sb->buffer.start + BINARY_OVERHEAD;
+  uint8_t *p = put_varint(start, n);
+  
+  for (size_t i = 0; i < n; i++) {
+    struct hc_slog_field *f = fields[i];
+    p = binary_name_write(sb, p, f->name, lengths[i * 2]);
+    const struct hc_value *v = &f->value;
+
+    if (v->type == &HC_BOOL) {
+      *p++ = BINARY_BOOL;
+      *p++ = v->as_bool;
+    } else if (v->type == &HC_FIX) {
+      *p++ = BINARY_FIX;
+      p = put_varint(p, v->as_fix);
+    } else if (v->type == &HC_INT) {
+      // Zigzag encoding keeps small negative numbers short.
+      *p++ = BINARY_INT;
+      const int64_t x = v->as_int;
+      p = put_varint(p, ((uint64_t)x << 1) ^ (uint64_t)(x >> 63));
+    } else if (v->type == &HC_STRING) {
+      *p++ = BINARY_STRING;
+      p = put_bytes(p, v->as_string, lengths[i * 2 + 1]);
+    } else if (v->type == &HC_TIME) {
+      *p++ = BINARY_TIME;
+      memcpy(p, &v->as_time, sizeof(hc_time_t));
+      p += sizeof(hc_time_t);
+    } else if (v->type == &HC_UINT) {
+      *p++ = BINARY_UINT;
+      p = put_varint(p, v->as_uint);
+    } else {
+      hc_throw("Unsupported binary log type: %s", v->type->name);
+    }
+  }
+
+  uint8_t length[10];
+  const size_t ln = put_varint(length, p - start) - length;
+  memcpy(start - ln, length, ln);
+  hc_write(sb->out, start - ln, p - start + ln);
+}
+
+struct hc_slog_binary *_hc_slog_binary_init(struct hc_slog_binary *s,
+					    struct hc_stream *out,
+					    const struct hc_slog_binary_opts opts) {
+  s->slog = (struct hc_slog){
+    .deinit = binary_deinit,
+    .write = binary_write,
+    .level = HC_SLOG_INFO
+  };
+
+  s->out = out;
+  s->opts = opts;
+  hc_set_init(&s->names, &hc_malloc_default,
+	      sizeof(struct binary_name),
+	      name_cmp);
+  s->names.key = binary_name_key;
+  hc_vector_init(&s->buffer, &hc_malloc_default, 1);
+  return s;
+}
+
+static bool read_varint(struct hc_stream *in, uint64_t *v) {
+  *v = 0;
+  
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t b;
+    
+    if (!hc_read(in, &b, 1)) {
+      if (shift) { hc_throw("Truncated binary log"); }
+      return false;
+    }
+
+    *v |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) { return true; }
+  }
+
+  hc_throw("Invalid varint in binary log");
+  return false;
+}
+
+static uint64_t get_varint(const uint8_t **p, const uint8_t *end) {
+  uint64_t v = 0;
+  
+  for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+    const uint8_t b = *(*p)++;
+    v |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) { return v; }
+  }
+
+  hc_throw("Invalid varint in binary log");
+  return 0;
+}
+
+static const char *get_bytes(const uint8_t **p, const uint8_t *end) {
+  const uint64_t n = get_varint(p, end);
+
+  if (!n || n > end - *p || (*p)[n - 1]) {
+    hc_throw("Invalid string in binary log");
+  }
+
+  const char *s = (const char *)*p;
+  *p += n;
+  return s;
+}
+
+static uint8_t get_byte(const uint8_t **p, const uint8_t *end) {
+  if (*p == end) { hc_throw("Truncated binary log record"); }
+  return *(*p)++;
+}
+
+size_t hc_slog_binary_decode(struct hc_stream *in, struct hc_stream *out) {
+  struct hc_vector names, buffer;
+  hc_vector_init(&names, &hc_malloc_default, sizeof(char *));
+  hc_defer(hc_vector_deinit(&names));
+  hc_vector_init(&buffer, &hc_malloc_default, 1);
+  hc_defer(hc_vector_deinit(&buffer));
+  size_t records = 0;
+  
+  for (uint64_t n; read_varint(in, &n); records++) {
+    if (n > buffer.capacity) { hc_vector_grow(&buffer, n); }
+    
+    if (hc_read(in, buffer.start, n) != n) {
+      hc_throw("Truncated binary log record");
+    }
+
+    const uint8_t *p = buffer.start, *end = p + n;
+    const uint64_t length = get_varint(&p, end);
+
+    for (uint64_t i = 0; i < length; i++) {
+      uint64_t id = get_varint(&p, end);
+
+      // Names point into buffer, which is overwritten by the next record.
+      if (!id) {
+	*(char **)hc_vector_push(&names) = strdup(get_bytes(&p, end));
+	id = names.length;
+      } else if (id > names.length) {
+	hc_throw("Unknown name in binary log: %" PRIu64, id);
+      }
+
+      if (i) { hc_puts(out, ", "); }
+      hc_puts(out, *(char **)hc_vector_get(&names, id - 1));
+      hc_putc(out, '=');
+      struct hc_value v;
+      
+      switch (get_byte(&p, end)) {
+      case BINARY_BOOL:
+	hc_value_init(&v, &HC_BOOL)->as_bool = get_byte(&p, end);
+	break;
+      case BINARY_FIX:
+	hc_value_init(&v, &HC_FIX)->as_fix = get_varint(&p, end);
+	break;
+      case BINARY_INT: {
+	const uint64_t x = get_varint(&p, end);
+	hc_value_init(&v, &HC_INT)->as_int = (int64_t)(x >> 1) ^ -(int64_t)(x & 1);
+	break;
+      }
+      case BINARY_STRING:
+	hc_value_init(&v, &HC_STRING)->as_string = (char *)get_bytes(&p, end);
+	break;
+      case BINARY_TIME:
+	if (end - p < sizeof(hc_time_t)) {
+	  hc_throw("Truncated binary log record");
+	}
+	
+	hc_value_init(&v, &HC_TIME);
+	memcpy(&v.as_time, p, sizeof(hc_time_t));
+	p += sizeof(hc_time_t);
+	break;
+      case BINARY_UINT:
+	hc_value_init(&v, &HC_UINT)->as_uint = get_varint(&p, end);
+	break;
+      default:
+	hc_throw("Invalid type in binary log");
+      }
+
+      hc_value_write(&v, out);
+    }
+
+    hc_putc(out, '\n');
+  }
+
+  hc_vector_do(&names, n) {
+    free(*(char **)n);
+  }
+
+  return records;
+}
+
+static uint8_t *json_escape_char(uint8_t *p, const uint8_t c) {
+  static const char hex[] = "0123456789abcdef";
+  *p++ = '\\';
+  
+  switch (c) {
+  case '"':
+  case '\\':
+    *p++ = c;
+    break;
+  case '\b':
+    *p++ = 'b';
+    break;
+  case '\f':
+    *p++ = 'f';
+    break;
+  case '\n':
+    *p++ = 'n';
+    break;
+  case '\r':
+    *p++ = 'r';
+    break;
+  case '\t':
+    *p++ = 't';
+    break;
+  default:
+    memcpy(p, "u00", 3);
+    p[3] = hex[c >> 4];
+    p[4] = hex[c & 0xf];
+    p += 5;
+  }
+
+  return p;
+}
+
+static bool json_needs_escape(const uint8_t c) {
+  return c < 0x20 || c == '"' || c == '\\';
+}
+
+uint8_t *hc_json_escape(uint8_t *out, const char *in, const size_t n) {
+  const uint8_t *s = (const uint8_t *)in;
+  size_t i = 0;
+  
+#ifdef __SSE2__
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1f);
+
+  // Copies 16 bytes at a time until something needs escaping.
+  while (n - i >= 16) {
+    const __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+    
+    const __m128i m =
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote),
+				_mm_cmpeq_epi8(x, backslash)),
+		   _mm_cmpeq_epi8(_mm_max_epu8(x, control), control));
+    
+    const int mask = _mm_movemask_epi8(m);
+    
+    if (!mask) {
+      _mm_storeu_si128((__m128i *)out, x);
+      out += 16;
+      i += 16;
+      continue;
+    }
+
+    const int j = __builtin_ctz(mask);
+    memcpy(out, s + i, j);
+    out = json_escape_char(out + j, s[i + j]);
+    i += j + 1;
+  }
+#endif
+
+  for (; i < n; i++) {
+    const uint8_t c = s[i];
+
+    if (json_needs_escape(c)) {
+      out = json_escape_char(out, c);
+    } else {
+      *out++ = c;
+    }
+  }
+
+  return out;
+}
+
+// Escaping may grow strings up to six times (\u00XX).
+#define JSON_ESCAPE_MAX(n) ((n) * 6)
+
+// Records are rendered into memory streams, which always lend out memory;
+// other streams get strings escaped in pieces of this size.
+#define JSON_STRING_CHUNK 256
+
+static void json_string(struct hc_stream *out, const char *s) {
+  const size_t n = strlen(s);
+  uint8_t *const start = hc_acquire_write(out, JSON_ESCAPE_MAX(n) + 2);
+
+  if (!start) {
+    uint8_t buf[JSON_ESCAPE_MAX(JSON_STRING_CHUNK)];
+    hc_putc(out, '"');
+    
+    for (size_t i = 0; i < n; i += JSON_STRING_CHUNK) {
+      const size_t m = hc_min(n - i, JSON_STRING_CHUNK);
+      hc_write(out, buf, hc_json_escape(buf, s + i, m) - buf);
+    }
+
+    hc_putc(out, '"');
+    return;
+  }
+  
+  uint8_t *p = start;
+  *p++ = '"';
+  p = hc_json_escape(p, s, n);
+  *p++ = '"';
+  hc_commit_write(out, p - start);
+}
+
+static void json_time(struct hc_stream *out, const hc_time_t *t) {
+  char buf[HC_TIME_LENGTH_MAX + 1];
+  buf[0] = '"';
+  const size_t n = hc_time_format(t, HC_TIME_FORMAT, buf + 1, sizeof(buf) - 2);
+  buf[n + 1] = '"';
+  hc_write(out, (const uint8_t *)buf, n + 2);
+}
+
+struct json_key {
+  char *name, *key;
+  size_t length;
+};
+
+static const void *json_key_key(const void *x) {
+  return ((const struct json_key *)x)->name;
+}
+
+static void json_deinit(struct hc_slog *s) {
+  struct hc_slog_json *sj = hc_baseof(s, struct hc_slog_json, slog);
+
+  hc_vector_do(&sj->keys.items, k) {
+    struct json_key *jk = k;
+    free(jk->name);
+    free(jk->key);
+  }
+  
+  hc_set_deinit(&sj->keys);
+  hc_stream_deinit(&sj->buffer.stream);
+  if (sj->opts.close_out) { hc_stream_deinit(sj->out); }
+}
+
+static const struct json_key *json_key(struct hc_slog_json *s,
+				       const char *name) {
+  struct json_key *k = hc_set_find(&s->keys, name);
+  if (k) { return k; }
+
+  // Keys are escaped and quoted once, with a trailing colon.
+  const size_t n = strlen(name);
+  uint8_t *key = malloc(JSON_ESCAPE_MAX(n) + 3), *p = key;
+  *p++ = '"';
+  p = hc_json_escape(p, name, n);
+  *p++ = '"';
+  *p++ = ':';
+
+  k = hc_set_add(&s->keys, name, false);
+  
+  *k = (struct json_key){
+    .name = strdup(name),
+    .key = (char *)key,
+    .length = p - key
+  };
+
+  return k;
+}
+
+static void json_fields(struct hc_slog_json *s,
+			struct hc_stream *out,
+			const bool separate,
+			const size_t n,
+			struct hc_slog_field *fields[]) {
+  for (size_t i = 0; i < n; i++) {
+    struct hc_slog_field *f = fields[i];
+    if (i || separate) { hc_putc(out, ','); }
+    const struct json_key *k = json_key(s, f->name);
+    hc_write(out, (const uint8_t *)k->key, k->length);
+    const struct hc_value *v = &f->value;
+
+    if (v->type == &HC_BOOL) {
+      hc_puts(out, v->as_bool ? "true" : "false");
+    } else if (v->type == &HC_FIX) {
+      hc_fix_print(v->as_fix, out);
+    } else if (v->type == &HC_INT) {
+      hc_put_int(out, v->as_int);
+    } else if (v->type == &HC_STRING) {
+      json_string(out, v->as_string);
+    } else if (v->type == &HC_TIME) {
+      json_time(out, &v->as_time);
+    } else if (v->type == &HC_UINT) {
+      hc_put_uint(out, v->as_uint);
+    } else {
+      hc_throw("Unsupported JSON log type: %s", v->type->name);
+    }
+  }
+}
+
+static void json_render(struct hc_slog *s,
+			struct hc_memory_stream *prefix,
+			const size_t n,
+			struct hc_slog_field *fields[]) {
+  struct hc_slog_json *sj = hc_baseof(s, struct hc_slog_json, slog);
+  json_fields(sj, &prefix->stream, prefix->data.length, n, fields);
+}
+
+static void json_write_prefixed(struct hc_slog *s,
+				const uint8_t *prefix,
+				const size_t prefix_length,
+				const size_t n,
+				struct hc_slog_field *fields[]) {
+  struct hc_slog_json *sj = hc_baseof(s, struct hc_slog_json, slog);
+  struct hc_stream *out = &sj->buffer.stream;
+  hc_vector_clear(&sj->buffer.data);
+  hc_putc(out, '{');
+  if (prefix_length) { hc_write(out, prefix, prefix_length); }
+  json_fields(sj, out, prefix_length, n, fields);
+  hc_puts(out, "}\n");
+  hc_write(sj->out, sj->buffer.data.start, sj->buffer.data.length);
+}
+
+static void json_write(struct hc_slog *s,
+		       const size_t n,
+		       struct hc_slog_field *fields[]) {
+  json_write_prefixed(s, NULL, 0, n, fields);
+}
+
+struct hc_slog_json *_hc_slog_json_init(struct hc_slog_json *s,
+					struct hc_stream *out,
+					const struct hc_slog_json_opts opts) {
+  s->slog = (struct hc_slog){
+    .deinit = json_deinit,
+    .write = json_write,
+    .render = json_render,
+    .write_prefixed = json_write_prefixed,
+    .level = HC_SLOG_INFO
+  };
+
+  s->out = out;
+  s->opts = opts;
+  hc_set_init(&s->keys, &hc_malloc_default,
+	      sizeof(struct json_key),
+	      name_cmp);
+  s->keys.key = json_key_key;
+  hc_memory_stream_init(&s->buffer, &hc_malloc_default);
+  return s;
+}
+
+static void context_deinit(struct hc_slog *s) {
+  struct hc_slog_context *sc = hc_baseof(s, struct hc_slog_context, slog);
+
+  for (size_t i = 0; i < sc->length; i++) {
+    struct hc_slog_field *f = sc->fields[i];
+    if (f->lazy) { hc_value_deinit(&f->value); }
+    field_free(f);
+  }
+
+  free(sc->fields);
+  hc_stream_deinit(&sc->prefix.stream);
+}
+
+static void context_write(struct hc_slog *s,
+			  const size_t n,
+			  struct hc_slog_field *fields[]) {
+  struct hc_slog_context *c = hc_baseof(s, struct hc_slog_context, slog);
+
+  if (c->target) {
+    c->target->write_prefixed(c->target,
+			      c->prefix.data.start, c->prefix.data.length,
+			      n, fields);
+    
+    return;
+  }
+  
+  struct hc_slog_field *fs[c->length + n];
+  memcpy(fs, c->fields, sizeof(struct hc_slog_field *) * c->length);
+  memcpy(fs + c->length, fields, sizeof(struct hc_slog_field *) * n);
+  slog_write(c->parent, c->length + n, fs);
+}
+
+struct hc_slog_context *hc_slog_context_init(struct hc_slog_context *c,
+					     size_t length,
+					     struct hc_slog_field *fields[]) {
+  c->parent = hc_slog();
+
+  c->slog = (struct hc_slog){
+    .deinit = context_deinit,
+    .write = context_write,
+    .level = c->parent->level
+  };
+
+  c->length = length;
+  size_t s = sizeof(struct hc_slog_field *) * length;
+  c->fields = malloc(s);
+  memcpy(c->fields, fields, s);
+
+  // Lazy fields are evaluated once, like the rest of the context.
+  for (size_t i = 0; i < length; i++) {
+    struct hc_slog_field *f = fields[i];
+    if (f->lazy) { f->lazy(&f->value, f->lazy_arg); }
+  }
+  
+  hc_memory_stream_init(&c->prefix, &hc_malloc_default);
+  c->target = NULL;
+
+  // Nested contexts extend the prefix of their parent.
+  if (c->parent->write == context_write) {
+    struct hc_slog_context *pc =
+      hc_baseof(c->parent, struct hc_slog_context, slog);
+    
+    if (pc->target) {
+      c->target = pc->target;
+      const struct hc_vector *p = &pc->prefix.data;
+      if (p->length) { hc_write(&c->prefix.stream, p->start, p->length); }
+    }
+  } else if (c->parent->render) {
+    c->target = c->parent;
+  }
+
+  if (c->target) {
+    c->target->render(c->target, &c->prefix, length, fields);
+  }
+  
+  return c;
+}
+
+static void file_write_all(struct hc_slog_file *s,
+			   const uint8_t *data,
+			   const size_t n) {
+  for (size_t i = 0; i < n;) {
+    const ssize_t r = write(s->fd, data + i, n - i);
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      hc_throw("Failed writing to '%s': %d", s->path, errno);
+    }
+
+    i += r;
+  }
+}
+
+static void file_flush(struct hc_slog_file *s) {
+  file_write_all(s, s->buffer, s->length);
+  s->length = 0;
+}
+
+static size_t file_stream_write(struct hc_stream *_s,
+				const uint8_t *data,
+				const size_t n) {
+  struct hc_slog_file *s = hc_baseof(_s, struct hc_slog_file, stream);
+  if (s->length + n > s->opts.buffer_size) { file_flush(s); }
+
+  if (n > s->opts.buffer_size) {
+    file_write_all(s, data, n);
+  } else {
+    memcpy(s->buffer + s->length, data, n);
+    s->length += n;
+  }
+
+  s->size += n;
+  s->dirty = true;
+  return n;
+}
+
+static uint8_t *file_acquire_write(struct hc_stream *_s, const size_t n) {
+  struct hc_slog_file *s = hc_baseof(_s, struct hc_slog_file, stream);
+  if (n > s->opts.buffer_size) { return NULL; }
+  if (s->length + n > s->opts.buffer_size) { file_flush(s); }
+  return s->buffer + s->length;
+}
+
+static void file_commit_write(struct hc_stream *_s, const size_t n) {
+  struct hc_slog_file *s = hc_baseof(_s, struct hc_slog_file, stream);
+  s->length += n;
+  s->size += n;
+  s->dirty = true;
+}
+
+static void file_open(struct hc_slog_file *s) {
+  s->fd = open(s->path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+  if (s->fd == -1) {
+    hc_throw("Failed opening '%s': %d", s->path, errno);
+  }
+
+  struct stat st;
+  
+  if (fstat(s->fd, &st) == -1) {
+    hc_throw("Failed reading size of '%s': %d", s->path, errno);
+  }
+  
+  s->size = st.st_size;
+
+  // Reserves space without changing the size, not every file system
+  // supports it so failures are ignored.
+  if (s->opts.preallocate && s->opts.max_size > s->size) {
+    fallocate(s->fd, FALLOC_FL_KEEP_SIZE, s->size, s->opts.max_size - s->size);
+  }
+  
+  s->opened = hc_now();
+}
+
+static void file_sync(struct hc_slog_file *s) {
+  file_flush(s);
+
+  if (fdatasync(s->fd) == -1) {
+    hc_throw("Failed syncing '%s': %d", s->path, errno);
+  }
+
+  s->dirty = false;
+}
+
+void hc_slog_file_sync(struct hc_slog_file *s) {
+  pthread_mutex_lock(&s->lock);
+  file_sync(s);
+  pthread_mutex_unlock(&s->lock);
+}
+
+static void file_rotate(struct hc_slog_file *s) {
+  file_sync(s);
+  close(s->fd);
+  const size_t n = strlen(s->path) + 16;
+  char from[n], to[n];
+
+  // Shifts older files up one step, the oldest is overwritten.
+  for (int i = s->opts.keep; i > 0; i--) {
+    if (i == 1) {
+      strcpy(from, s->path);
+    } else {
+      snprintf(from, n, "%s.%d", s->path, i - 1);
+    }
+
+    snprintf(to, n, "%s.%d", s->path, i);
+
+    if (rename(from, to) == -1 && errno != ENOENT) {
+      hc_throw("Failed renaming '%s': %d", from, errno);
+    }
+  }
+
+  if (!s->opts.keep) { unlink(s->path); }
+  file_open(s);
+}
+
+void hc_slog_file_rotate(struct hc_slog_file *s) {
+  pthread_mutex_lock(&s->lock);
+  file_rotate(s);
+  pthread_mutex_unlock(&s->lock);
+}
+
+// Everything written since the last round is committed in one go, the
+// timer keeps records from lingering in the buffer when the log goes
+// quiet.
+static void *file_run(void *arg) {
+  struct hc_slog_file *s = arg;
+  pthread_mutex_lock(&s->lock);
+  
+  while (!s->stopping) {
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    t.tv_sec += s->opts.sync_ms / 1000;
+    t.tv_nsec += (s->opts.sync_ms % 1000) * 1000000;
+    if (t.tv_nsec >= 1000000000) { t.tv_sec++; t.tv_nsec -= 1000000000; }
+    pthread_cond_timedwait(&s->stop, &s->lock, &t);
+    if (s->dirty) { file_sync(s); }
+  }
+
+  pthread_mutex_unlock(&s->lock);
+  return NULL;
+}
+
+static void file_write_prefixed(struct hc_slog *_s,
+				const uint8_t *prefix,
+				const size_t prefix_length,
+				const size_t n,
+				struct hc_slog_field *fields[]) {
+  struct hc_slog_file *s = hc_baseof(_s, struct hc_slog_file, slog);
+  pthread_mutex_lock(&s->lock);
+  hc_time_t now = s->opts.rotate_seconds ? hc_now() : s->opened;
+
+  // Rotating between records keeps them whole.
+  if ((s->opts.max_size && s->size >= s->opts.max_size) ||
+      (s->opts.rotate_seconds &&
+       now.value.tv_sec - s->opened.value.tv_sec >= s->opts.rotate_seconds)) {
+    file_rotate(s);
+  }
+  
+  struct hc_slog *t = &s->text.slog;
+  t->write_prefixed(t, prefix, prefix_length, n, fields);
+  pthread_mutex_unlock(&s->lock);
+}
+
+static void file_write(struct hc_slog *s,
+		       const size_t n,
+		       struct hc_slog_field *fields[]) {
+  file_write_prefixed(s, NULL, 0, n, fields);
+}
+
+static void file_render(struct hc_slog *_s,
+			struct hc_memory_stream *prefix,
+			const size_t n,
+			struct hc_slog_field *fields[]) {
+  struct hc_slog_file *s = hc_baseof(_s, struct hc_slog_file, slog);
+  s->text.slog.render(&s->text.slog, prefix, n, fields);
+}
+
+static void file_deinit(struct hc_slog *_s) {
+  struct hc_slog_file *s = hc_baseof(_s, struct hc_slog_file, slog);
+
+  if (s->opts.sync_ms) {
+    pthread_mutex_lock(&s->lock);
+    s->stopping = true;
+    pthread_cond_signal(&s->stop);
+    pthread_mutex_unlock(&s->lock);
+    pthread_join(s->thread, NULL);
+  }
+
+  file_sync(s);
+  close(s->fd);
+  pthread_cond_destroy(&s->stop);
+  pthread_mutex_destroy(&s->lock);
+  free(s->buffer);
+  free(s->path);
+}
+
+struct hc_slog_file *_hc_slog_file_init(struct hc_slog_file *s,
+					const char *path,
+					const struct hc_slog_file_opts opts) {
+  s->slog = (struct hc_slog){
+    .deinit = file_deinit,
+    .write = file_write,
+    .render = file_render,
+    .write_prefixed = file_write_prefixed,
+    .level = HC_SLOG_INFO
+  };
+
+  s->stream = (struct hc_stream){
+    .write         = file_stream_write,
+    .acquire_write = file_acquire_write,
+    .commit_write  = file_commit_write
+  };
+
+  hc_slog_stream_init(&s->text, &s->stream);
+  s->opts = opts;
+  s->path = strdup(path);
+  s->buffer = malloc(opts.buffer_size);
+  s->length = 0;
+  s->dirty = s->stopping = false;
+  pthread_mutex_init(&s->lock, NULL);
+  pthread_cond_init(&s->stop, NULL);
+  file_open(s);
+
+  if (opts.sync_ms) {
+    const int r = pthread_create(&s->thread, NULL, file_run, s);
+    if (r) { hc_throw("Failed starting log sync: %d", r); }
+  }
+  
+  return s;
+}
+
+// Owned names and values get a bit each.
+_Static_assert(2 * HC_SLOG_RECORD_FIELDS <= 32,
+	       "HC_SLOG_RECORD_FIELDS is too large for the owned mask");
+
+struct hc_slog_record {
+  size_t sequence, length, arena_length;
+  uint32_t owned;
+  struct hc_slog_field fields[HC_SLOG_RECORD_FIELDS], *overflow;
+  char arena[HC_SLOG_RECORD_SIZE];
+};
+
+static char *record_string(struct hc_slog_record *r,
+			   const char *s,
+			   const int bit) {
+  const size_t n = strlen(s) + 1;
+
+  // Strings that don't fit in the record are allocated separately.
+  if (r->arena_length + n > HC_SLOG_RECORD_SIZE) {
+    r->owned |= 1u << bit;
+    return strdup(s);
+  }
+
+  char *result = r->arena + r->arena_length;
+  memcpy(result, s, n);
+  r->arena_length += n;
+  return result;
+}
+
+static void record_init(struct hc_slog_record *r,
+			const size_t n,
+			struct hc_slog_field *fields[]) {
+  const size_t m = hc_min(n, (size_t)HC_SLOG_RECORD_FIELDS);
+  r->length = n;
+  r->arena_length = 0;
+  r->owned = 0;
+  
+  for (size_t i = 0; i < m; i++) {
+    struct hc_slog_field *src = fields[i], *dst = r->fields + i;
+    dst->name = record_string(r, src->name, i);
+    dst->borrowed = true;
+    dst->lazy = NULL;
+    const struct hc_type *t = src->value.type;
+    
+    if (t == &HC_STRING) {
+      dst->value.type = t;
+      dst->value.as_string = record_string(r,
+					   src->value.as_string,
+					   i + HC_SLOG_RECORD_FIELDS);
+    } else if (t->copy) {
+      hc_value_copy(&dst->value, &src->value);
+      r->owned |= 1u << (i + HC_SLOG_RECORD_FIELDS);
+    } else {
+      dst->value = src->value;
+    }
+  }
+
+  // Fields that don't fit in the record are allocated separately, names
+  // and values are always copied.
+  r->overflow = (n > m) ? malloc((n - m) * sizeof(struct hc_slog_field)) : NULL;
+  
+  for (size_t i = m; i < n; i++) {
+    struct hc_slog_field *src = fields[i], *dst = r->overflow + i - m;
+    dst->name = strdup(src->name);
+    dst->borrowed = true;
+    dst->lazy = NULL;
+    hc_value_copy(&dst->value, &src->value);
+  }
+}
+
+static struct hc_slog_field *record_field(struct hc_slog_record *r,
+					  const size_t i) {
+  return (i < HC_SLOG_RECORD_FIELDS)
+    ? r->fields + i
+    : r->overflow + i - HC_SLOG_RECORD_FIELDS;
+}
+
+static void record_deinit(struct hc_slog_record *r) {
+  const size_t m = hc_min(r->length, (size_t)HC_SLOG_RECORD_FIELDS);
+  
+  for (size_t i = 0; i < m; i++) {
+    struct hc_slog_field *f = r->fields + i;
+    if (r->owned & (1u << i)) { free(f->name); }
+
+    if (r->owned & (1u << (i + HC_SLOG_RECORD_FIELDS))) {
+      hc_value_deinit(&f->value);
+    }
+  }
+
+  for (size_t i = m; i < r->length; i++) {
+    struct hc_slog_field *f = r->overflow + i - m;
+    free(f->name);
+    if (f->value.type->copy) { hc_value_deinit(&f->value); }
+  }
+
+  free(r->overflow);
+}
+
+static void async_wake(struct hc_slog_async *s) {
+  pthread_mutex_lock(&s->lock);
+  pthread_cond_signal(&s->ready);
+  pthread_mutex_unlock(&s->lock);
+}
+
+static bool async_push(struct hc_slog_async *s,
+		       const size_t n,
+		       struct hc_slog_field *fields[]) {
+  size_t pos = __atomic_load_n(&s->tail, __ATOMIC_RELAXED);
+
+  for (;;) {
+    struct hc_slog_record *r = s->records + (pos & s->mask);
+    const size_t seq = __atomic_load_n(&r->sequence, __ATOMIC_ACQUIRE);
+    const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+    if (diff < 0) {
+      return false;
+    }
+
+    // Slots are claimed by bumping the tail, the sequence tells the
+    // writer thread when the record is ready.
+    if (!diff && __atomic_compare_exchange_n(&s->tail, &pos, pos + 1,
+					     true,
+					     __ATOMIC_RELAXED,
+					     __ATOMIC_RELAXED)) {
+      record_init(r, n, fields);
+      __atomic_store_n(&r->sequence, pos + 1, __ATOMIC_RELEASE);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+      if (__atomic_load_n(&s->waiting, __ATOMIC_RELAXED)) {
+	async_wake(s);
+      }
+      
+      return true;
+    }
+
+    if (diff) {
+      pos = __atomic_load_n(&s->tail, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+static void async_write(struct hc_slog *_s,
+			const size_t n,
+			struct hc_slog_field *fields[]) {
+  struct hc_slog_async *s = hc_baseof(_s, struct hc_slog_async, slog);
+
+  if (s->opts.backpressure == HC_SLOG_SAMPLE) {
+    const size_t used =
+      __atomic_load_n(&s->tail, __ATOMIC_RELAXED) -
+      __atomic_load_n(&s->head, __ATOMIC_RELAXED);
+
+    // Once the queue is half full, only every nth record gets in.
+    if (used > s->opts.capacity / 2 &&
+	__atomic_fetch_add(&s->sampled, 1, __ATOMIC_RELAXED) %
+	s->opts.sample) {
+      __atomic_fetch_add(&s->dropped, 1, __ATOMIC_RELAXED);
+      return;
+    }
+  }
+
+  while (!async_push(s, n, fields)) {
+    if (s->opts.backpressure != HC_SLOG_BLOCK) {
+      __atomic_fetch_add(&s->dropped, 1, __ATOMIC_RELAXED);
+      return;
+    }
+    
+    sched_yield();
+  }
+}
+
+static struct hc_slog_record *async_peek(struct hc_slog_async *s) {
+  struct hc_slog_record *r = s->records + (s->head & s->mask);
+  const size_t seq = __atomic_load_n(&r->sequence, __ATOMIC_ACQUIRE);
+  return (seq == s->head + 1) ? r : NULL;
+}
+
+static size_t async_drain(struct hc_slog_async *s) {
+  size_t result = 0;
+  
+  for (struct hc_slog_record *r; (r = async_peek(s)); result++) {
+    struct hc_slog_field *fs[r->length];
+    for (size_t i = 0; i < r->length; i++) { fs[i] = record_field(r, i); }
+    slog_write(s->target, r->length, fs);
+    record_deinit(r);
+    
+    // Releasing the slot makes it available one lap later.
+    __atomic_store_n(&r->sequence,
+		     s->head + s->opts.capacity,
+		     __ATOMIC_RELEASE);
+    
+    __atomic_store_n(&s->head, s->head + 1, __ATOMIC_RELAXED);
+  }
+
+  __atomic_fetch_add(&s->written, result, __ATOMIC_RELAXED);
+  return result;
+}
+
+static void *async_run(void *arg) {
+  struct hc_slog_async *s = arg;
+
+  for (;;) {
+    if (async_drain(s)) {
+      continue;
+    }
+
+    pthread_mutex_lock(&s->lock);
+    __atomic_store_n(&s->waiting, true, __ATOMIC_SEQ_CST);
+    const bool stopping = __atomic_load_n(&s->stopping, __ATOMIC_SEQ_CST);
+
+    // The queue is checked again after announcing that we're waiting,
+    // to avoid missing records pushed in between.
+    if (!async_peek(s) && !stopping) {
+      struct timespec t;
+      clock_gettime(CLOCK_REALTIME, &t);
+      t.tv_nsec += 10000000;
+      if (t.tv_nsec >= 1000000000) { t.tv_sec++; t.tv_nsec -= 1000000000; }
+      pthread_cond_timedwait(&s->ready, &s->lock, &t);
+    }
+    
+    __atomic_store_n(&s->waiting, false, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&s->lock);
+
+    if (stopping && !async_peek(s)) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+static void async_deinit(struct hc_slog *_s) {
+  struct hc_slog_async *s = hc_baseof(_s, struct hc_slog_async, slog);
+  __atomic_store_n(&s->stopping, true, __ATOMIC_SEQ_CST);
+  async_wake(s);
+  pthread_join(s->thread, NULL);
+  pthread_cond_destroy(&s->ready);
+  pthread_mutex_destroy(&s->lock);
+  free(s->records);
+}
+
+struct hc_slog_async *_hc_slog_async_init(struct hc_slog_async *s,
+					  struct hc_slog *target,
+					  struct hc_slog_async_opts opts) {
+  s->slog = (struct hc_slog){
+    .deinit = async_deinit,
+    .write = async_write,
+    .level = target->level
+  };
+
+  s->target = target;
+  size_t capacity = 1;
+  while (capacity < opts.capacity) { capacity *= 2; }
+  opts.capacity = capacity;
+  s->opts = opts;
+  s->mask = capacity - 1;
+  s->records = malloc(sizeof(struct hc_slog_record) * capacity);
+
+  for (size_t i = 0; i < capacity; i++) {
+    s->records[i].sequence = i;
+  }
+  
+  s->tail = s->head = 0;
+  s->dropped = s->sampled = s->written = 0;
+  s->waiting = s->stopping = false;
+  pthread_mutex_init(&s->lock, NULL);
+  pthread_cond_init(&s->ready, NULL);
+
+  const int r = pthread_create(&s->thread, NULL, async_run, s);
+  if (r) { hc_throw("Failed starting log writer: %d", r); }
+  
+  return s;
+}
+
+size_t hc_slog_async_dropped(struct hc_slog_async *s) {
+  return __atomic_load_n(&s->dropped, __ATOMIC_RELAXED);
+}
+
+size_t hc_slog_async_written(struct hc_slog_async *s) {
+  return __atomic_load_n(&s->written, __ATOMIC_RELAXED);
+}
@@ -1,112 +1,365 @@
-#ifndef HACKTICAL_SLOG_H
-#define HACKTICAL_SLOG_H
-
-#include <stdint.h>
-#include <stdio.h>
-#include <time.h>
-
-#include "chrono/chrono.h"
-#include "reflect/reflect.h"
-#include "stream1/stream1.h"
-
-#define __hc_slog_do(s, _ps)			\
-  for (struct hc_slog *_ps = hc_slog();		\
-       _ps && (_hc_slog = (s));			\
-       _hc_slog = _ps, _ps = NULL)
-
-#define _hc_slog_do(s)				\
-  __hc_slog_do((s), hc_unique(ps))
-
-#define hc_slog_do(s)				\
-  _hc_slog_do(&(s)->slog)
-
-struct hc_slog;
-
-struct hc_slog_field {
-  char *name;
-  struct hc_value value;
-};
-
-struct hc_slog {
-  void (*deinit)(struct hc_slog *);
-  void (*write)(struct hc_slog *, size_t, struct hc_slog_field *[]);
-};
-
-struct hc_slog_stream_opts {
-  bool close_out;
-};
-
-struct hc_slog_stream {
-  struct hc_slog slog;
-  struct hc_stream *out;
-  struct hc_slog_stream_opts opts;
-};
-
-extern __thread struct hc_slog *_hc_slog;
-struct hc_slog *hc_slog();
-
-struct hc_slog_field;
-
-struct hc_slog_field *hc_slog_bool(const char *name, bool value);
-struct hc_slog_field *hc_slog_int(const char *name, int value);
-struct hc_slog_field *hc_slog_string(const char *name, const char *value);
-struct hc_slog_field *hc_slog_time(const char *name, hc_time_t value);
-
-#define hc_slog_deinit(s)			\
-  _hc_slog_deinit(&(s)->slog)
-
-#define _hc_slog_write(s, ...) do {				\
-    hc_array(struct hc_slog_field *, fs, ##__VA_ARGS__);	\
-    __hc_slog_write((s), fs_n, fs_a);				\
-  } while (0)
-
-#define hc_slog_write(...)			\
-  _hc_slog_write(hc_slog(), ##__VA_ARGS__)
-
-#define hc_slog_stream_init(s, out, ...)			\
-  _hc_slog_stream_init(s, out, (struct hc_slog_stream_opts){	\
-      .close_out = false,					\
-      ##__VA_ARGS__						\
-    })
-
-struct hc_slog_stream *_hc_slog_stream_init(struct hc_slog_stream *s,
-					    struct hc_stream *out,
-					    struct hc_slog_stream_opts opts);
-
-void _hc_slog_deinit(struct hc_slog *s);
-
-void __hc_slog_write(struct hc_slog *s,
-		     size_t n,
-		     struct hc_slog_field *fields[]);
-
-#define __hc_slog_context_do(_c, _fs, _a, _n, ...)			\
-  struct hc_slog_context _c;						\
-  hc_array(struct hc_slog_field *, _fs, ##__VA_ARGS__);			\
-  hc_slog_context_init(&_c, _n, _a);					\
-  hc_defer(hc_slog_deinit(&_c));					\
-  hc_slog_do(&_c)
-
-#define _hc_slog_context_do(_c, _fs, ...)	\
-  __hc_slog_context_do(_c,			\
-		       _fs,			\
-		       hc_id(_fs, _a),		\
-		       hc_id(_fs, _n),		\
-		       ##__VA_ARGS__)
-
-#define hc_slog_context_do(...)			\
-  _hc_slog_context_do(hc_unique(slog_c),	\
-		      hc_unique(slog_fs),	\
-		      ##__VA_ARGS__)
-
-struct hc_slog_context {
-  struct hc_slog slog;
-  struct hc_slog *parent;
-  size_t length;
-  struct hc_slog_field **fields;
-};
-
-struct hc_slog_context *hc_slog_context_init(struct hc_slog_context *c,
-					     size_t length,
-					     struct hc_slog_field *fields[]);
-
-#endif
+#ifndef HACKTICAL_SLOG_H
+#define HACKTICAL_SLOG_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "chrono/chrono.h"
+#include "reflect/reflect.h"
+#include "set/set.h"
+#include "stream1/stream1.h"
+
+#define __hc_slog_do(s, _ps)			\
+  for (struct hc_slog *_ps = hc_slog();		\
+       _ps && (_hc_slog = (s));			\
+       _hc_slog = _ps, _ps = NULL)
+
+#define _hc_slog_do(s)				\
+  __hc_slog_do((s), hc_unique(ps))
+
+#define hc_slog_do(s)				\
+  _hc_slog_do(&(s)->slog)
+
+struct hc_slog;
+
+enum hc_slog_level {
+  HC_SLOG_DEBUG, HC_SLOG_INFO, HC_SLOG_WARN, HC_SLOG_ERROR
+};
+
+typedef void (*hc_slog_lazy_t)(struct hc_value *, void *);
+
+struct hc_slog_field {
+  char *name;
+  struct hc_value value;
+  bool borrowed;
+  hc_slog_lazy_t lazy;
+  void *lazy_arg;
+};
+
+struct hc_slog {
+  void (*deinit)(struct hc_slog *);
+  void (*write)(struct hc_slog *, size_t, struct hc_slog_field *[]);
+
+  // Optional, renders fields into a prefix that's passed to write_prefixed.
+  void (*render)(struct hc_slog *,
+		 struct hc_memory_stream *,
+		 size_t,
+		 struct hc_slog_field *[]);
+  
+  void (*write_prefixed)(struct hc_slog *,
+			 const uint8_t *,
+			 size_t,
+			 size_t,
+			 struct hc_slog_field *[]);
+  
+  enum hc_slog_level level;
+};
+
+struct hc_slog_stream_opts {
+  bool close_out;
+};
+
+struct hc_slog_stream {
+  struct hc_slog slog;
+  struct hc_stream *out;
+  struct hc_slog_stream_opts opts;
+};
+
+extern __thread struct hc_slog *_hc_slog;
+struct hc_slog *hc_slog();
+
+struct hc_slog_field;
+
+struct hc_slog_field *hc_slog_bool(const char *name, bool value);
+struct hc_slog_field *hc_slog_int(const char *name, int value);
+struct hc_slog_field *hc_slog_string(const char *name, const char *value);
+struct hc_slog_field *hc_slog_time(const char *name, hc_time_t value);
+struct hc_slog_field *hc_slog_uint(const char *name, uint64_t value);
+
+// Borrowed fields live on the stack and are never freed, which means
+// they're only valid until the end of the enclosing block.
+
+#define _hc_slog_ref(n, t, ...)						\
+  (&(struct hc_slog_field){						\
+    .name = (char *)(n),						\
+    .value = {.type = &(t), __VA_ARGS__},				\
+    .borrowed = true							\
+  })
+
+#define hc_slog_bool_ref(n, v)			\
+  _hc_slog_ref(n, HC_BOOL, .as_bool = (v))
+
+#define hc_slog_int_ref(n, v)			\
+  _hc_slog_ref(n, HC_INT, .as_int = (v))
+
+#define hc_slog_string_ref(n, v)		\
+  _hc_slog_ref(n, HC_STRING, .as_string = (char *)(v))
+
+#define hc_slog_fix_ref(n, v)			\
+  _hc_slog_ref(n, HC_FIX, .as_fix = (v))
+
+#define hc_slog_time_ref(n, v)			\
+  _hc_slog_ref(n, HC_TIME, .as_time = (v))
+
+#define hc_slog_uint_ref(n, v)			\
+  _hc_slog_ref(n, HC_UINT, .as_uint = (v))
+
+// Lazy fields call f(value, arg) to get their value when written, the
+// value is deinitialized afterwards.
+
+#define hc_slog_lazy(n, f, arg)				\
+  (&(struct hc_slog_field){				\
+    .name = (char *)(n),				\
+    .value = {.type = NULL},				\
+    .borrowed = true,					\
+    .lazy = (f),					\
+    .lazy_arg = (arg)					\
+  })
+
+#define hc_slog_deinit(s)			\
+  _hc_slog_deinit(&(s)->slog)
+
+#define _hc_slog_write(s, ...) do {				\
+    hc_array(struct hc_slog_field *, fs, ##__VA_ARGS__);	\
+    __hc_slog_write((s), fs_n, fs_a);				\
+  } while (0)
+
+#define hc_slog_write(...)			\
+  _hc_slog_write(hc_slog(), ##__VA_ARGS__)
+
+#define hc_slog_enabled(l)			\
+  ((l) >= hc_slog()->level)
+
+// Fields are only evaluated if the current log accepts the level.
+
+#define _hc_slog_log(_s, l, ...) do {			\
+    struct hc_slog *_s = hc_slog();			\
+    if ((l) >= _s->level) {				\
+      _hc_slog_write(_s, ##__VA_ARGS__);		\
+    }							\
+  } while (0)
+
+#define hc_slog_log(l, ...)				\
+  _hc_slog_log(hc_unique(slog_s), l, ##__VA_ARGS__)
+
+#define hc_slog_debug(...)			\
+  hc_slog_log(HC_SLOG_DEBUG, ##__VA_ARGS__)
+
+#define hc_slog_info(...)			\
+  hc_slog_log(HC_SLOG_INFO, ##__VA_ARGS__)
+
+#define hc_slog_warn(...)			\
+  hc_slog_log(HC_SLOG_WARN, ##__VA_ARGS__)
+
+#define hc_slog_error(...)			\
+  hc_slog_log(HC_SLOG_ERROR, ##__VA_ARGS__)
+
+// Writes every nth enabled call from each call site and thread.
+
+#define _hc_slog_sample(_s, _i, l, n, ...) do {		\
+    static __thread size_t _i = 0;			\
+    struct hc_slog *_s = hc_slog();			\
+    if ((l) >= _s->level && !(_i++ % (n))) {		\
+      _hc_slog_write(_s, ##__VA_ARGS__);		\
+    }							\
+  } while (0)
+
+#define hc_slog_sample(l, n, ...)				\
+  _hc_slog_sample(hc_unique(slog_s), hc_unique(slog_i),		\
+		  l, n, ##__VA_ARGS__)
+
+#define hc_slog_stream_init(s, out, ...)			\
+  _hc_slog_stream_init(s, out, (struct hc_slog_stream_opts){	\
+      .close_out = false,					\
+      ##__VA_ARGS__						\
+    })
+
+void hc_slog_histogram(const char *name, const struct hc_histogram *h);
+
+struct hc_slog_stream *_hc_slog_stream_init(struct hc_slog_stream *s,
+					    struct hc_stream *out,
+					    struct hc_slog_stream_opts opts);
+
+struct hc_slog_binary_opts {
+  bool close_out;
+};
+
+struct hc_slog_binary {
+  struct hc_slog slog;
+  struct hc_stream *out;
+  struct hc_slog_binary_opts opts;
+  struct hc_set names;
+  struct hc_vector buffer;
+};
+
+#define hc_slog_binary_init(s, out, ...)			\
+  _hc_slog_binary_init(s, out, (struct hc_slog_binary_opts){	\
+      .close_out = false,					\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_slog_binary *_hc_slog_binary_init(struct hc_slog_binary *s,
+					    struct hc_stream *out,
+					    struct hc_slog_binary_opts opts);
+
+size_t hc_slog_binary_decode(struct hc_stream *in, struct hc_stream *out);
+
+struct hc_slog_json_opts {
+  bool close_out;
+};
+
+struct hc_slog_json {
+  struct hc_slog slog;
+  struct hc_stream *out;
+  struct hc_slog_json_opts opts;
+  struct hc_set keys;
+  struct hc_memory_stream buffer;
+};
+
+#define hc_slog_json_init(s, out, ...)				\
+  _hc_slog_json_init(s, out, (struct hc_slog_json_opts){	\
+      .close_out = false,					\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_slog_json *_hc_slog_json_init(struct hc_slog_json *s,
+					struct hc_stream *out,
+					struct hc_slog_json_opts opts);
+
+uint8_t *hc_json_escape(uint8_t *out, const char *in, size_t n);
+
+void _hc_slog_deinit(struct hc_slog *s);
+
+void __hc_slog_write(struct hc_slog *s,
+		     size_t n,
+		     struct hc_slog_field *fields[]);
+
+#define __hc_slog_context_do(_c, _fs, _a, _n, ...)			\
+  struct hc_slog_context _c;						\
+  hc_array(struct hc_slog_field *, _fs, ##__VA_ARGS__);			\
+  hc_slog_context_init(&_c, _n, _a);					\
+  hc_defer(hc_slog_deinit(&_c));					\
+  hc_slog_do(&_c)
+
+#define _hc_slog_context_do(_c, _fs, ...)	\
+  __hc_slog_context_do(_c,			\
+		       _fs,			\
+		       hc_id(_fs, _a),		\
+		       hc_id(_fs, _n),		\
+		       ##__VA_ARGS__)
+
+#define hc_slog_context_do(...)			\
+  _hc_slog_context_do(hc_unique(slog_c),	\
+		      hc_unique(slog_fs),	\
+		      ##__VA_ARGS__)
+
+struct hc_slog_context {
+  struct hc_slog slog;
+  struct hc_slog *parent, *target;
+  size_t length;
+  struct hc_slog_field **fields;
+  struct hc_memory_stream prefix;
+};
+
+struct hc_slog_context *hc_slog_context_init(struct hc_slog_context *c,
+					     size_t length,
+					     struct hc_slog_field *fields[]);
+
+#define HC_SLOG_FILE_BUFFER_SIZE (1024 * 1024)
+
+struct hc_slog_file_opts {
+  size_t buffer_size, max_size;
+  time_t rotate_seconds;
+  int keep;
+  bool preallocate;
+  uint64_t sync_ms;
+};
+
+struct hc_slog_file {
+  struct hc_slog slog;
+  struct hc_slog_stream text;
+  struct hc_stream stream;
+  struct hc_slog_file_opts opts;
+  char *path;
+  int fd;
+  uint8_t *buffer;
+  size_t length, size;
+  hc_time_t opened;
+  bool dirty, stopping;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t stop;
+};
+
+#define hc_slog_file_init(s, path, ...)				\
+  _hc_slog_file_init(s, path, (struct hc_slog_file_opts){	\
+      .buffer_size = HC_SLOG_FILE_BUFFER_SIZE,			\
+      .max_size = 0,						\
+      .rotate_seconds = 0,					\
+      .keep = 5,						\
+      .preallocate = true,					\
+      .sync_ms = 1000,						\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_slog_file *_hc_slog_file_init(struct hc_slog_file *s,
+					const char *path,
+					struct hc_slog_file_opts opts);
+
+void hc_slog_file_sync(struct hc_slog_file *s);
+void hc_slog_file_rotate(struct hc_slog_file *s);
+
+#define HC_SLOG_RECORD_FIELDS 16
+#define HC_SLOG_RECORD_SIZE 512
+
+enum hc_slog_backpressure {
+  HC_SLOG_BLOCK, HC_SLOG_DROP, HC_SLOG_SAMPLE
+};
+
+struct hc_slog_record;
+
+struct hc_slog_async_opts {
+  size_t capacity;
+  enum hc_slog_backpressure backpressure;
+  size_t sample;
+};
+
+struct hc_slog_async {
+  struct hc_slog slog;
+  struct hc_slog *target;
+  struct hc_slog_async_opts opts;
+  struct hc_slog_record *records;
+  size_t mask;
+
+  // Shared by producers.
+  alignas(64) size_t tail;
+  size_t dropped, sampled;
+
+  // Owned by the writer thread.
+  alignas(64) size_t head;
+  size_t written;
+  bool waiting, stopping;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+};
+
+#define hc_slog_async_init(s, target, ...)				\
+  _hc_slog_async_init(s, target, (struct hc_slog_async_opts){		\
+      .capacity = 1024,							\
+      .backpressure = HC_SLOG_BLOCK,					\
+      .sample = 10,							\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_slog_async *_hc_slog_async_init(struct hc_slog_async *s,
+					  struct hc_slog *target,
+					  struct hc_slog_async_opts opts);
+
+size_t hc_slog_async_dropped(struct hc_slog_async *s);
+size_t hc_slog_async_written(struct hc_slog_async *s);
+
+#endif
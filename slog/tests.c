@@ -1,31 +1,453 @@
-#include <assert.h>
-#include <string.h>
-
-#include "slog.h"
-#include "malloc1/malloc1.h"
-
-void slog_tests() {
-  struct hc_memory_stream out;
-  hc_memory_stream_init(&out, &hc_malloc_default);
-  
-  struct hc_slog_stream s;
-  hc_slog_stream_init(&s, &out.stream, .close_out=true);
-  
-  hc_slog_do(&s) {
-    hc_slog_context_do(hc_slog_string("string", "abc")) {
-      hc_time_t t = hc_time(2025, 4, 13, 1, 40, 0);
-      
-      hc_slog_write(hc_slog_bool("bool", true),
-		    hc_slog_int("int", 42),
-		    hc_slog_time("time", t));
-    }
-  }
-
-  assert(strcmp("string=\"abc\", "
-		"bool=true, "
-		"int=42, "
-		"time=2025-04-13T01:40:00\n",
-		hc_memory_stream_string(&out)) == 0);
-  
-  hc_slog_deinit(&s);  
-}
+#include <assert.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "slog.h"
+#include "malloc1/malloc1.h"
+
+static void *async_producer(void *arg) {
+  struct hc_slog_async *s = arg;
+
+  hc_slog_do(s) {
+    for (int i = 0; i < 1000; i++) {
+      hc_slog_write(hc_slog_int("i", i), hc_slog_string("s", "abc"));
+    }
+  }
+
+  return NULL;
+}
+
+static void async_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&out.stream));
+  struct hc_slog_stream ss;
+  hc_slog_stream_init(&ss, &out.stream);
+  
+  {
+    struct hc_slog_async s;
+    hc_slog_async_init(&s, &ss.slog, .capacity = 64);
+    pthread_t producers[2];
+    
+    for (int i = 0; i < 2; i++) {
+      pthread_create(producers + i, NULL, async_producer, &s);
+    }
+
+    for (int i = 0; i < 2; i++) {
+      pthread_join(producers[i], NULL);
+    }
+
+    hc_slog_deinit(&s);
+    assert(hc_slog_async_written(&s) == 2000);
+    assert(!hc_slog_async_dropped(&s));
+  }
+
+  size_t lines = 0;
+
+  for (const char *p = hc_memory_stream_string(&out); *p; p++) {
+    if (*p == '\n') { lines++; }
+  }
+
+  assert(lines == 2000);
+  
+  char long_string[HC_SLOG_RECORD_SIZE * 2];
+  memset(long_string, 'x', sizeof(long_string) - 1);
+  long_string[sizeof(long_string) - 1] = 0;
+  struct hc_slog_async s;
+  hc_slog_async_init(&s, &ss.slog, .capacity = 4, .backpressure = HC_SLOG_DROP);
+
+  hc_slog_do(&s) {
+    for (int i = 0; i < 1000; i++) {
+      hc_slog_write(hc_slog_string("s", long_string));
+    }
+  }
+
+  hc_slog_deinit(&s);
+  assert(hc_slog_async_written(&s) + hc_slog_async_dropped(&s) == 1000);
+  
+  // Fields beyond the size of a record, including context fields.
+  hc_stream_deinit(&out.stream);
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_slog_async_init(&s, &ss.slog);
+
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_string("context", "abc")) {
+      hc_slog_write(hc_slog_int("f1", 1), hc_slog_int("f2", 2),
+		    hc_slog_int("f3", 3), hc_slog_int("f4", 4),
+		    hc_slog_int("f5", 5), hc_slog_int("f6", 6),
+		    hc_slog_int("f7", 7), hc_slog_int("f8", 8),
+		    hc_slog_int("f9", 9), hc_slog_int("f10", 10),
+		    hc_slog_int("f11", 11), hc_slog_int("f12", 12),
+		    hc_slog_int("f13", 13), hc_slog_int("f14", 14),
+		    hc_slog_int("f15", 15), hc_slog_int("f16", 16),
+		    hc_slog_string("f17", "def"),
+		    hc_slog_int_ref("f18", 18));
+    }
+  }
+
+  hc_slog_deinit(&s);
+
+  assert(strcmp("context=\"abc\", f1=1, f2=2, f3=3, f4=4, f5=5, f6=6, "
+		"f7=7, f8=8, f9=9, f10=10, f11=11, f12=12, f13=13, f14=14, "
+		"f15=15, f16=16, f17=\"def\", f18=18\n",
+		hc_memory_stream_string(&out)) == 0);
+}
+
+static void borrowed_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  char value[] = "abc";
+  
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_string_ref("string", value)) {
+      hc_time_t t = hc_time(2025, 4, 13, 1, 40, 0);
+      
+      hc_slog_write(hc_slog_bool_ref("bool", true),
+		    hc_slog_int("int", 42),
+		    hc_slog_time_ref("time", t));
+    }
+  }
+
+  assert(strcmp("string=\"abc\", "
+		"bool=true, "
+		"int=42, "
+		"time=2025-04-13T01:40:00\n",
+		hc_memory_stream_string(&out)) == 0);
+  
+  hc_slog_deinit(&s);  
+}
+
+static void binary_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&out.stream));
+  struct hc_slog_binary s;
+  hc_slog_binary_init(&s, &out.stream);
+  hc_time_t t = hc_time(2025, 4, 13, 1, 40, 0);
+  
+  hc_slog_do(&s) {
+    for (int i = -1; i < 2; i++) {
+      hc_slog_write(hc_slog_string("string", "abc"),
+		    hc_slog_bool("bool", i),
+		    hc_slog_int("int", i * 1000),
+		    hc_slog_time("time", t),
+		    hc_slog_uint("uint", UINT64_MAX >> (i + 1)));
+    }
+  }
+
+  hc_slog_deinit(&s);
+  struct hc_memory_stream text;
+  hc_memory_stream_init(&text, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&text.stream));
+  assert(hc_slog_binary_decode(&out.stream, &text.stream) == 3);
+  
+  assert(strcmp("string=\"abc\", bool=true, int=-1000, "
+		"time=2025-04-13T01:40:00, uint=18446744073709551615\n"
+		"string=\"abc\", bool=false, int=0, "
+		"time=2025-04-13T01:40:00, uint=9223372036854775807\n"
+		"string=\"abc\", bool=true, int=1000, "
+		"time=2025-04-13T01:40:00, uint=4611686018427387903\n",
+		hc_memory_stream_string(&text)) == 0);
+}
+
+static int level_calls = 0;
+
+static int level_value() {
+  return ++level_calls;
+}
+
+static void level_lazy(struct hc_value *v, void *arg) {
+  (*(int *)arg)++;
+  hc_value_init(v, &HC_STRING)->as_string = strdup("lazy");
+}
+
+static void level_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  assert(s.slog.level == HC_SLOG_INFO);
+  int lazy_calls = 0;
+  
+  hc_slog_do(&s) {
+    assert(!hc_slog_enabled(HC_SLOG_DEBUG));
+    hc_slog_debug(hc_slog_int("debug", level_value()),
+		  hc_slog_lazy("lazy", level_lazy, &lazy_calls));
+    assert(!level_calls && !lazy_calls);
+    
+    hc_slog_info(hc_slog_int("info", level_value()),
+		 hc_slog_lazy("lazy", level_lazy, &lazy_calls));
+    assert(level_calls == 1 && lazy_calls == 1);
+
+    s.slog.level = HC_SLOG_ERROR;
+    hc_slog_warn(hc_slog_int("warn", level_value()));
+    assert(level_calls == 1);
+
+    s.slog.level = HC_SLOG_DEBUG;
+    
+    for (int i = 0; i < 10; i++) {
+      hc_slog_sample(HC_SLOG_DEBUG, 4, hc_slog_int_ref("i", i));
+    }
+  }
+
+  assert(strcmp("info=1, lazy=\"lazy\"\n"
+		"i=0\n"
+		"i=4\n"
+		"i=8\n",
+		hc_memory_stream_string(&out)) == 0);
+  
+  hc_slog_deinit(&s);  
+}
+
+static void lazy_context_tests() {
+  int lazy_calls = 0;
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_lazy("lazy", level_lazy, &lazy_calls)) {
+      hc_slog_write(hc_slog_int_ref("int", 1));
+      hc_slog_write(hc_slog_int_ref("int", 2));
+    }
+  }
+
+  assert(lazy_calls == 1);
+  
+  assert(strcmp("lazy=\"lazy\", int=1\n"
+		"lazy=\"lazy\", int=2\n",
+		hc_memory_stream_string(&out)) == 0);
+
+  hc_slog_deinit(&s);
+
+  // Logs without prefix support get the context fields on every write.
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&out.stream));
+  struct hc_slog_binary b;
+  hc_slog_binary_init(&b, &out.stream);
+
+  hc_slog_do(&b) {
+    hc_slog_context_do(hc_slog_lazy("lazy", level_lazy, &lazy_calls)) {
+      hc_slog_write(hc_slog_int_ref("int", 1));
+    }
+  }
+
+  assert(lazy_calls == 2);
+  hc_slog_deinit(&b);
+  struct hc_memory_stream text;
+  hc_memory_stream_init(&text, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&text.stream));
+  assert(hc_slog_binary_decode(&out.stream, &text.stream) == 1);
+
+  assert(strcmp("lazy=\"lazy\", int=1\n",
+		hc_memory_stream_string(&text)) == 0);
+}
+
+static void context_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  char value[] = "abc";
+  
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_string_ref("outer", value)) {
+      // Context fields are rendered once up front.
+      value[0] = 'x';
+      hc_slog_write(hc_slog_int_ref("int", 1));
+      
+      hc_slog_context_do(hc_slog_bool("inner", true),
+			 hc_slog_int("id", 42)) {
+	hc_slog_write(hc_slog_int_ref("int", 2));
+      }
+    }
+  }
+
+  assert(strcmp("outer=\"abc\", int=1\n"
+		"outer=\"abc\", inner=true, id=42, int=2\n",
+		hc_memory_stream_string(&out)) == 0);
+  
+  hc_slog_deinit(&s);
+
+  // Logs that can't render prefixes get all fields on every write.
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&out.stream));
+  struct hc_slog_binary b;
+  hc_slog_binary_init(&b, &out.stream);
+
+  hc_slog_do(&b) {
+    hc_slog_context_do(hc_slog_string("outer", "abc")) {
+      hc_slog_context_do(hc_slog_int("id", 42)) {
+	hc_slog_write(hc_slog_int_ref("int", 2));
+      }
+    }
+  }
+
+  hc_slog_deinit(&b);
+  struct hc_memory_stream text;
+  hc_memory_stream_init(&text, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&text.stream));
+  hc_slog_binary_decode(&out.stream, &text.stream);
+  
+  assert(strcmp("outer=\"abc\", id=42, int=2\n",
+		hc_memory_stream_string(&text)) == 0);
+}
+
+static void json_tests() {
+  const char *in = "0123456789abcdef\"quoted\"\\\n\x01 tail";
+  uint8_t out[256];
+  const size_t n = hc_json_escape(out, in, strlen(in)) - out;
+  const char *expected = "0123456789abcdef\\\"quoted\\\"\\\\\\n\\u0001 tail";
+  assert(n == strlen(expected) && memcmp(out, expected, n) == 0);
+  
+  struct hc_memory_stream text;
+  hc_memory_stream_init(&text, &hc_malloc_default);
+  struct hc_slog_json s;
+  hc_slog_json_init(&s, &text.stream, .close_out = true);
+  hc_time_t t = hc_time(2025, 4, 13, 1, 40, 0);
+  
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_string_ref("na\"me", "abc")) {
+      hc_slog_write(hc_slog_bool_ref("bool", true),
+		    hc_slog_int_ref("int", -42),
+		    hc_slog_time_ref("time", t));
+    }
+
+    hc_slog_write(hc_slog_string_ref("string", "a\tb"));
+  }
+
+  assert(strcmp("{\"na\\\"me\":\"abc\",\"bool\":true,\"int\":-42,"
+		"\"time\":\"2025-04-13T01:40:00\"}\n"
+		"{\"string\":\"a\\tb\"}\n",
+		hc_memory_stream_string(&text)) == 0);
+  
+  hc_slog_deinit(&s);
+}
+
+static size_t file_size(const char *path) {
+  struct stat st;
+  return (stat(path, &st) == -1) ? 0 : st.st_size;
+}
+
+static void file_tests() {
+  char dir[] = "/tmp/hc_slog_XXXXXX";
+  assert(mkdtemp(dir));
+  char path[64], rotated[64];
+  snprintf(path, sizeof(path), "%s/app.log", dir);
+  
+  struct hc_slog_file s;
+  hc_slog_file_init(&s, path, .max_size = 64, .keep = 2, .sync_ms = 0);
+
+  // Lines are 5 bytes, which means files are rotated after 13 lines.
+  hc_slog_do(&s) {
+    for (int i = 0; i < 30; i++) {
+      hc_slog_write(hc_slog_int_ref("i", 10 + i));
+    }
+  }
+
+  hc_slog_deinit(&s);
+  assert(file_size(path) == 4 * 5);
+  
+  for (int i = 1; i <= 3; i++) {
+    snprintf(rotated, sizeof(rotated), "%s.%d", path, i);
+    assert(file_size(rotated) == ((i < 3) ? 13 * 5 : 0));
+    unlink(rotated);
+  }
+
+  FILE *f = fopen(path, "r");
+  char line[16];
+  assert(fgets(line, sizeof(line), f) && strcmp(line, "i=36\n") == 0);
+  fclose(f);
+  unlink(path);
+
+  // Buffered records reach the file without another write.
+  hc_slog_file_init(&s, path, .sync_ms = 1);
+  
+  hc_slog_do(&s) {
+    hc_slog_write(hc_slog_int_ref("i", 42));
+  }
+
+  for (int i = 0; i < 1000 && !file_size(path); i++) { hc_sleep(1000000); }
+  assert(file_size(path) == 5);
+  hc_slog_deinit(&s);
+  unlink(path);
+  rmdir(dir);
+}
+
+static void slog_histogram_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  struct hc_histogram h;
+  hc_histogram_init(&h);
+  for (int i = 1; i <= 100; i++) { hc_histogram_record(&h, i); }
+  
+  hc_slog_do(&s) {
+    hc_slog_histogram("latency", &h);
+  }
+
+  assert(strcmp("histogram=\"latency\", n=100, min=1, p50=50, p90=90, "
+		"p99=99, p999=100, max=100\n",
+		hc_memory_stream_string(&out)) == 0);
+
+  // The entire 64-bit range is logged as is.
+  hc_slog_deinit(&s);
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  hc_histogram_clear(&h);
+  hc_histogram_record(&h, UINT64_MAX);
+  
+  hc_slog_do(&s) {
+    hc_slog_histogram("latency", &h);
+  }
+
+  assert(strstr(hc_memory_stream_string(&out),
+		", max=18446744073709551615\n"));
+
+  hc_histogram_deinit(&h);
+  hc_slog_deinit(&s);
+}
+
+void slog_tests() {
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  
+  struct hc_slog_stream s;
+  hc_slog_stream_init(&s, &out.stream, .close_out=true);
+  
+  hc_slog_do(&s) {
+    hc_slog_context_do(hc_slog_string("string", "abc")) {
+      hc_time_t t = hc_time(2025, 4, 13, 1, 40, 0);
+      
+      hc_slog_write(hc_slog_bool("bool", true),
+		    hc_slog_int("int", 42),
+		    hc_slog_time("time", t));
+    }
+  }
+
+  assert(strcmp("string=\"abc\", "
+		"bool=true, "
+		"int=42, "
+		"time=2025-04-13T01:40:00\n",
+		hc_memory_stream_string(&out)) == 0);
+  
+  hc_slog_deinit(&s);  
+  borrowed_tests();
+  binary_tests();
+  level_tests();
+  lazy_context_tests();
+  context_tests();
+  json_tests();
+  file_tests();
+  slog_histogram_tests();
+  async_tests();
+}
@@ -0,0 +1,201 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "chrono/chrono.h"
+#include "stream1.h"
+
+#define STREAM_BYTES (4 * 1024 * 1024)
+#define STREAM_LINE "level=info msg=\"request done\" id=42\n"
+
+struct bench_target {
+  const char *name;
+  FILE *(*open)();
+  struct hc_stream *stream;
+  struct hc_file_stream file;
+  struct hc_memory_stream memory;
+};
+
+static FILE *open_null() {
+  return fopen("/dev/null", "w");
+}
+
+static FILE *open_tmpfs() {
+  char path[] = "/dev/shm/hc_bench_XXXXXX";
+  const int fd = mkstemp(path);
+
+  // Not every system has a tmpfs mounted at /dev/shm.
+  if (fd == -1) {
+    return tmpfile();
+  }
+
+  unlink(path);
+  return fdopen(fd, "w+");
+}
+
+static void target_open(struct bench_target *t, const size_t buffer_size) {
+  if (t->open) {
+    FILE *f = t->open();
+    setvbuf(f, NULL, _IOFBF, buffer_size);
+    hc_file_stream_init(&t->file, f, .close_file = true);
+    t->stream = &t->file.stream;
+  } else {
+    hc_memory_stream_init(&t->memory, &hc_malloc_default);
+    t->stream = &t->memory.stream;
+  }
+}
+
+static void target_rewind(struct bench_target *t) {
+  if (t->open) {
+    fflush(t->file.file);
+    rewind(t->file.file);
+  } else {
+    t->memory.rpos = 0;
+  }
+}
+
+static void bench_report(const hc_time_t *t,
+			 const char *op,
+			 const struct bench_target *target,
+			 const size_t buffer_size,
+			 const size_t bytes,
+			 const size_t calls) {
+  const uint64_t ns = hc_time_ns(t);
+
+  printf("%s %s/%zu: %" PRIu64 "ns %.1fMB/s %.1fMcalls/s\n",
+	 op, target->name, buffer_size, ns,
+	 bytes * 1000.0 / ns, calls * 1000.0 / ns);
+}
+
+static void bench_putc(struct bench_target *target, const size_t size) {
+  target_open(target, size);
+  hc_time_t t = hc_now();
+
+  for (int i = 0; i < STREAM_BYTES; i++) {
+    hc_putc(target->stream, 'x');
+  }
+
+  bench_report(&t, "putc", target, size, STREAM_BYTES, STREAM_BYTES);
+  hc_stream_deinit(target->stream);
+}
+
+static void bench_puts(struct bench_target *target, const size_t size) {
+  target_open(target, size);
+  const size_t n = STREAM_BYTES / strlen(STREAM_LINE);
+  hc_time_t t = hc_now();
+
+  for (size_t i = 0; i < n; i++) {
+    hc_puts(target->stream, STREAM_LINE);
+  }
+
+  bench_report(&t, "puts", target, size, n * strlen(STREAM_LINE), n);
+  hc_stream_deinit(target->stream);
+}
+
+static void bench_printf(struct bench_target *target, const size_t size) {
+  target_open(target, size);
+  const size_t n = STREAM_BYTES / strlen(STREAM_LINE);
+  size_t bytes = 0;
+  hc_time_t t = hc_now();
+
+  for (size_t i = 0; i < n; i++) {
+    bytes += hc_printf(target->stream,
+		       "level=%s msg=\"%s\" id=%zu\n",
+		       "info", "request done", i);
+  }
+
+  bench_report(&t, "printf", target, size, bytes, n);
+  hc_stream_deinit(target->stream);
+}
+
+static void bench_gets(struct bench_target *target, const size_t size) {
+  target_open(target, size);
+  const size_t n = STREAM_BYTES / strlen(STREAM_LINE);
+
+  for (size_t i = 0; i < n; i++) {
+    hc_puts(target->stream, STREAM_LINE);
+  }
+
+  target_rewind(target);
+  hc_time_t t = hc_now();
+
+  for (char *line; (line = hc_gets(target->stream, &hc_malloc_default));) {
+    free(line);
+  }
+
+  bench_report(&t, "gets", target, size, n * strlen(STREAM_LINE), n);
+  hc_stream_deinit(target->stream);
+}
+
+static void bench_write(struct bench_target *target,
+			const size_t size,
+			const uint8_t *data) {
+  target_open(target, size);
+  const size_t n = STREAM_BYTES / size;
+  hc_time_t t = hc_now();
+
+  for (size_t i = 0; i < n; i++) {
+    hc_write(target->stream, data, size);
+  }
+
+  bench_report(&t, "write", target, size, n * size, n);
+  hc_stream_deinit(target->stream);
+}
+
+static void bench_read(struct bench_target *target,
+		       const size_t size,
+		       uint8_t *data) {
+  target_open(target, size);
+  const size_t n = STREAM_BYTES / size;
+
+  for (size_t i = 0; i < n; i++) {
+    hc_write(target->stream, data, size);
+  }
+
+  target_rewind(target);
+  hc_time_t t = hc_now();
+  size_t bytes = 0;
+
+  for (size_t m; (m = hc_read(target->stream, data, size)); bytes += m);
+  bench_report(&t, "read", target, size, bytes, n);
+  hc_stream_deinit(target->stream);
+}
+
+void stream1_benchmarks() {
+  struct bench_target targets[] = {
+    {.name = "null", .open = open_null},
+    {.name = "tmpfs", .open = open_tmpfs},
+    {.name = "memory", .open = NULL}
+  };
+
+  // Buffer sizes apply to stdio buffers as well as bulk reads/writes.
+  const size_t sizes[] = {512, 4096, 65536};
+  uint8_t *data = malloc(65536);
+  memset(data, 'x', 65536);
+
+  for (int i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+    struct bench_target *t = targets + i;
+
+    for (int j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+      const size_t size = sizes[j];
+
+      // Buffer size only matters for bulk operations in memory.
+      if (t->open || !j) {
+	bench_putc(t, size);
+	bench_puts(t, size);
+	bench_printf(t, size);
+      }
+
+      bench_write(t, size, data);
+
+      if (t->open != open_null) {
+	bench_gets(t, size);
+	bench_read(t, size, data);
+      }
+    }
+  }
+
+  free(data);
+}
@@ -1,176 +1,409 @@
-#include <assert.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "dynamic/dynamic.h"
-#include "error/error.h"
-#include "malloc1/malloc1.h"
-#include "macro/macro.h"
-#include "stream1.h"
-
-size_t hc_read(struct hc_stream *s, uint8_t *data, const size_t n) {
-  assert(s->read);
-  return s->read(s, data, n);
-}
-
-size_t hc_write(struct hc_stream *s, const uint8_t *data, const size_t n) {
-  assert(s->write);
-  return s->write(s, data, n);
-}
-
-char hc_getc(struct hc_stream *s) {
-  char c = 0;
-  return hc_read(s, (uint8_t *)&c, 1) ? c : 0;
-}
-
-char *hc_gets(struct hc_stream *s, struct hc_malloc *malloc) {
-  struct hc_vector out;
-  hc_vector_init(&out, malloc, 1);
-
-  for (;;) {
-    char c = hc_getc(s);
-
-    if (c == EOF) {
-      break;
-    }
-
-    *(char *)hc_vector_push(&out) = c;
-
-    if (c == '\n') {
-      break;
-    }
-  }
-
- 
-  *(char *)hc_vector_push(&out) = 0;
-  return (char *)out.start;
-}
-
-size_t hc_putc(struct hc_stream *s, const char data) {
-  const uint8_t d[2] = {data, 0};
-  return hc_write(s, d, 1);
-}
-
-size_t hc_puts(struct hc_stream *s, const char *data) {
-  return hc_write(s, (const uint8_t *)data, strlen(data));
-}
-
-size_t hc_vprintf(struct hc_stream *s,
-		  const char *spec,
-		  va_list args) {
-  char *data = hc_vsprintf(spec, args);
-  hc_defer(free(data));
-  return hc_write(s, (uint8_t *)data, strlen(data));
-}
-
-size_t hc_printf(struct hc_stream *s, const char *spec, ...) {
-  va_list args;
-  va_start(args, spec);
-  hc_defer(va_end(args));
-  return hc_vprintf(s, spec, args);
-}
-
-void hc_stream_deinit(struct hc_stream *s) {
-  assert(s->deinit);
-  s->deinit(s);
-}
-
-size_t file_read(struct hc_stream *s, uint8_t *data, const size_t n) {
-  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
-  assert(fs->file);
-  return fread(data, n, 1, fs->file);
-}
-
-size_t file_write(struct hc_stream *s, const uint8_t *data, const size_t n) {
-  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
-  assert(fs->file);
-  return fwrite(data, n, 1, fs->file);
-}
-
-void file_deinit(struct hc_stream *s) {
-  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
-
-  if (fs->opts.close_file) {
-    assert(fs->file);
- 
-    if (fclose(fs->file) == EOF) {
-      hc_throw("Failed closing file");
-    }
-    
-    fs->file = NULL;
-  }
-}
-
-struct hc_file_stream *_hc_file_stream_init(struct hc_file_stream *s,
-					    FILE *file,
-					    const struct hc_file_stream_opts opts) {
-  s->stream = (struct hc_stream){
-    .read   = file_read,
-    .write  = file_write,
-    .deinit = file_deinit,
-  };
-  
-  s->file = file;
-  s->opts = opts;
-  return s;
-};
-
-struct hc_stream *hc_stdout() {
-  static __thread bool init = true;
-  static __thread struct hc_file_stream s;
-
-  if (init) {
-    hc_file_stream_init(&s, stdout);
-    init = false;
-  }
-
-  return &s.stream;
-}
-
-size_t memory_read(struct hc_stream *s, uint8_t *data, size_t n) {
-  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
-
-  if (ms->rpos + n > ms->data.length) {
-    n = ms->data.length - ms->rpos;
-  }
-  
-  memcpy(data, ms->data.start + ms->rpos, n);
-  ms->rpos += n;
-  return n;
-}
-
-size_t memory_write(struct hc_stream *s,
-		    const uint8_t *data,
-		    const size_t n) {
-  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
-  uint8_t *const dst = hc_vector_insert(&ms->data, ms->data.length, n);
-  memcpy(dst, data, n);
-  return n;
-}
-
-void memory_deinit(struct hc_stream *s) {
-  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
-  hc_vector_deinit(&ms->data);
-}
-
-struct hc_memory_stream *hc_memory_stream_init(struct hc_memory_stream *s,
-					       struct hc_malloc *malloc) {
-  s->stream = (struct hc_stream){
-    .read   = memory_read,
-    .write  = memory_write,
-    .deinit = memory_deinit,
-  };
-  
-  hc_vector_init(&s->data, malloc, 1);
-  s->rpos = 0;
-  return s;
-}
-
-const char *hc_memory_stream_string(struct hc_memory_stream *s) {
-  if (!s->data.length || (*(s->data.end-1))) {
-    *(uint8_t *)hc_vector_push(&s->data) = 0;
-  }
-
-  return (const char *)s->data.start;
-}
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error/error.h"
+#include "malloc1/malloc1.h"
+#include "macro/macro.h"
+#include "stream1.h"
+
+size_t hc_read(struct hc_stream *s, uint8_t *data, const size_t n) {
+  assert(s->read);
+  return s->read(s, data, n);
+}
+
+size_t hc_write(struct hc_stream *s, const uint8_t *data, const size_t n) {
+  assert(s->write);
+  return s->write(s, data, n);
+}
+
+size_t hc_writev(struct hc_stream *s, const struct iovec *iov, const int n) {
+  if (s->writev) {
+    return s->writev(s, iov, n);
+  }
+
+  size_t result = 0;
+
+  for (int i = 0; i < n; i++) {
+    result += hc_write(s, iov[i].iov_base, iov[i].iov_len);
+  }
+
+  return result;
+}
+
+bool hc_stream_view(struct hc_stream *s,
+		    const uint8_t **data,
+		    size_t *n) {
+  if (!s->acquire_read) {
+    return false;
+  }
+
+  *data = s->acquire_read(s, n);
+  return true;
+}
+
+const uint8_t *hc_acquire_read(struct hc_stream *s, size_t *n) {
+  return s->acquire_read ? s->acquire_read(s, n) : NULL;
+}
+
+void hc_release_read(struct hc_stream *s, const size_t n) {
+  assert(s->release_read);
+  s->release_read(s, n);
+}
+
+uint8_t *hc_acquire_write(struct hc_stream *s, const size_t n) {
+  return s->acquire_write ? s->acquire_write(s, n) : NULL;
+}
+
+void hc_commit_write(struct hc_stream *s, const size_t n) {
+  assert(s->commit_write);
+  s->commit_write(s, n);
+}
+
+int hc_stream_fd(struct hc_stream *s) {
+  return s->fd ? s->fd(s) : -1;
+}
+
+char hc_getc(struct hc_stream *s) {
+  char c = 0;
+  return hc_read(s, (uint8_t *)&c, 1) ? c : 0;
+}
+
+char *hc_gets(struct hc_stream *s, struct hc_malloc *malloc) {
+  struct hc_vector out;
+  hc_vector_init(&out, malloc, 1);
+  bool done = false;
+  
+  // Streams that lend out memory are scanned a span at a time.
+  while (!done && s->acquire_read) {
+    size_t n = 0;
+    const uint8_t *p = hc_acquire_read(s, &n);
+
+    if (!n) {
+      break;
+    }
+
+    const uint8_t *nl = memchr(p, '\n', n);
+
+    if (nl) {
+      n = nl - p + 1;
+      done = true;
+    }
+
+    memcpy(hc_vector_insert(&out, out.length, n), p, n);
+    hc_release_read(s, n);
+  }
+  
+  while (!done && !s->acquire_read) {
+    uint8_t c = 0;
+
+    if (!hc_read(s, &c, 1)) {
+      break;
+    }
+
+    *(uint8_t *)hc_vector_push(&out) = c;
+    done = c == '\n';
+  }
+
+  if (!out.length) {
+    hc_vector_deinit(&out);
+    return NULL;
+  }
+  
+  *(char *)hc_vector_push(&out) = 0;
+  return (char *)out.start;
+}
+
+size_t hc_putc(struct hc_stream *s, const char data) {
+  const uint8_t d[2] = {data, 0};
+  return hc_write(s, d, 1);
+}
+
+size_t hc_puts(struct hc_stream *s, const char *data) {
+  return hc_write(s, (const uint8_t *)data, strlen(data));
+}
+
+static char *format_uint(char *end, uint64_t v, size_t min_digits) {
+  static const char digits[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+  char *p = end;
+
+  for (; v >= 100; v /= 100) {
+    p -= 2;
+    memcpy(p, digits + (v % 100) * 2, 2);
+  }
+
+  if (v >= 10) {
+    p -= 2;
+    memcpy(p, digits + v * 2, 2);
+  } else {
+    *--p = '0' + v;
+  }
+
+  while ((size_t)(end - p) < min_digits) {
+    *--p = '0';
+  }
+  
+  return p;
+}
+
+size_t hc_put_int(struct hc_stream *s, const int64_t data) {
+  return hc_put_decimal(s, data, 0);
+}
+
+static size_t count_digits(uint64_t v) {
+  size_t n = 1;
+  for (; v >= 10; v /= 10, n++);
+  return n;
+}
+
+static size_t put_digits(struct hc_stream *s,
+			 const uint64_t v,
+			 const bool negative,
+			 const uint8_t exp) {
+  assert(exp < 20);
+  const size_t digits = hc_max(count_digits(v), (size_t)exp + 1);
+  const size_t n = digits + (exp ? 1 : 0) + (negative ? 1 : 0);
+
+  // Digits go straight into the stream if it allows borrowing memory.
+  char buf[24];
+  char *p = (char *)hc_acquire_write(s, n);
+  char *const start = p ? p : buf;
+  char *const end = start + n;
+  p = format_uint(end, v, exp + 1);
+
+  if (exp) {
+    char *const frac = end - exp;
+    memmove(p - 1, p, frac - p);
+    p--;
+    *(frac - 1) = '.';
+  }
+
+  if (negative) {
+    *--p = '-';
+  }
+
+  assert(p == start);
+
+  if (start == buf) {
+    return hc_write(s, (uint8_t *)buf, n);
+  }
+
+  hc_commit_write(s, n);
+  return n;
+}
+
+size_t hc_put_uint(struct hc_stream *s, const uint64_t data) {
+  return put_digits(s, data, false, 0);
+}
+
+size_t hc_put_decimal(struct hc_stream *s,
+		      const int64_t data,
+		      const uint8_t exp) {
+  const uint64_t v = (data < 0) ? -(uint64_t)data : data;
+  return put_digits(s, v, data < 0, exp);
+}
+
+size_t hc_vprintf(struct hc_stream *s,
+		  const char *spec,
+		  va_list args) {
+  char buf[HC_PRINTF_BUFFER_SIZE];
+  uint8_t *dst = hc_acquire_write(s, sizeof(buf));
+  va_list tmp_args;
+  va_copy(tmp_args, args);
+  const int len = vsnprintf(dst ? (char *)dst : buf,
+			    sizeof(buf),
+			    spec,
+			    tmp_args);
+  va_end(tmp_args);
+
+  if (len < 0) {
+    hc_throw("Formatting '%s' failed: %d", spec, errno);
+  }
+  
+  if (len < sizeof(buf)) {
+    if (!dst) {
+      return hc_write(s, (uint8_t *)buf, len);
+    }
+
+    hc_commit_write(s, len);
+    return len;
+  }
+
+  char *data = malloc(len + 1);
+  hc_defer(free(data));
+  vsnprintf(data, len + 1, spec, args);
+  return hc_write(s, (uint8_t *)data, len);
+}
+
+size_t hc_printf(struct hc_stream *s, const char *spec, ...) {
+  va_list args;
+  va_start(args, spec);
+  hc_defer(va_end(args));
+  return hc_vprintf(s, spec, args);
+}
+
+void hc_stream_deinit(struct hc_stream *s) {
+  assert(s->deinit);
+  s->deinit(s);
+}
+
+size_t file_read(struct hc_stream *s, uint8_t *data, const size_t n) {
+  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
+  assert(fs->file);
+  return fread(data, 1, n, fs->file);
+}
+
+size_t file_write(struct hc_stream *s, const uint8_t *data, const size_t n) {
+  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
+  assert(fs->file);
+  return fwrite(data, 1, n, fs->file);
+}
+
+int file_descriptor(struct hc_stream *s) {
+  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
+  assert(fs->file);
+
+  // Buffered data has to be written before anyone else gets to touch
+  // the descriptor.
+  if (fflush(fs->file) == EOF) {
+    hc_throw("Failed flushing file: %d", errno);
+  }
+  
+  return fileno(fs->file);
+}
+
+void file_deinit(struct hc_stream *s) {
+  struct hc_file_stream *fs = hc_baseof(s, struct hc_file_stream, stream);
+
+  if (fs->opts.close_file) {
+    assert(fs->file);
+ 
+    if (fclose(fs->file) == EOF) {
+      hc_throw("Failed closing file");
+    }
+    
+    fs->file = NULL;
+  }
+}
+
+struct hc_file_stream *_hc_file_stream_init(struct hc_file_stream *s,
+					    FILE *file,
+					    const struct hc_file_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .read   = file_read,
+    .write  = file_write,
+    .fd     = file_descriptor,
+    .deinit = file_deinit,
+  };
+  
+  s->file = file;
+  s->opts = opts;
+  return s;
+};
+
+struct hc_stream *hc_stdout() {
+  static __thread bool init = true;
+  static __thread struct hc_file_stream s;
+
+  if (init) {
+    hc_file_stream_init(&s, stdout);
+    init = false;
+  }
+
+  return &s.stream;
+}
+
+size_t memory_read(struct hc_stream *s, uint8_t *data, size_t n) {
+  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
+
+  if (ms->rpos + n > ms->data.length) {
+    n = ms->data.length - ms->rpos;
+  }
+  
+  memcpy(data, ms->data.start + ms->rpos, n);
+  ms->rpos += n;
+  return n;
+}
+
+const uint8_t *memory_acquire_read(struct hc_stream *s, size_t *n) {
+  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
+  *n = ms->data.length - ms->rpos;
+  return ms->data.start + ms->rpos;
+}
+
+void memory_release_read(struct hc_stream *s, const size_t n) {
+  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
+  assert(ms->rpos + n <= ms->data.length);
+  ms->rpos += n;
+}
+
+uint8_t *memory_acquire_write(struct hc_stream *s, const size_t n) {
+  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
+  struct hc_vector *v = &ms->data;
+  
+  if (v->length + n > v->capacity) {
+    hc_vector_grow(v, hc_max(v->capacity * 2, v->length + n));
+  }
+
+  return v->end;
+}
+
+void memory_commit_write(struct hc_stream *s, const size_t n) {
+  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
+  struct hc_vector *v = &ms->data;
+  assert(v->length + n <= v->capacity);
+  v->length += n;
+  v->end += n;
+}
+
+size_t memory_write(struct hc_stream *s,
+		    const uint8_t *data,
+		    const size_t n) {
+  uint8_t *const dst = memory_acquire_write(s, n);
+  memcpy(dst, data, n);
+  memory_commit_write(s, n);
+  return n;
+}
+
+void memory_deinit(struct hc_stream *s) {
+  struct hc_memory_stream *ms = hc_baseof(s, struct hc_memory_stream, stream);
+  hc_vector_deinit(&ms->data);
+}
+
+struct hc_memory_stream *hc_memory_stream_init(struct hc_memory_stream *s,
+					       struct hc_malloc *malloc) {
+  s->stream = (struct hc_stream){
+    .read          = memory_read,
+    .write         = memory_write,
+    .acquire_read  = memory_acquire_read,
+    .release_read  = memory_release_read,
+    .acquire_write = memory_acquire_write,
+    .commit_write  = memory_commit_write,
+    .deinit        = memory_deinit,
+  };
+  
+  hc_vector_init(&s->data, malloc, 1);
+  s->rpos = 0;
+  return s;
+}
+
+const char *hc_memory_stream_string(struct hc_memory_stream *s) {
+  if (!s->data.length || (*(s->data.end-1))) {
+    *(uint8_t *)hc_vector_push(&s->data) = 0;
+  }
+
+  return (const char *)s->data.start;
+}
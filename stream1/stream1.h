@@ -1,70 +1,92 @@
-#ifndef HACKTICAL_STREAM1_H
-#define HACKTICAL_STREAM1_H
-
-#include <stdarg.h>
-#include <stddef.h>
-#include <stdint.h>
-#include <stdio.h>
-
-#include "vector/vector.h"
-
-struct hc_stream {  
-  size_t (*read)(struct hc_stream *, uint8_t *, size_t);
-  size_t (*write)(struct hc_stream *, const uint8_t *, size_t);
-  void (*deinit)(struct hc_stream *);
-};
-
-size_t hc_read(struct hc_stream *s, uint8_t *data, size_t n);
-size_t hc_write(struct hc_stream *s, const uint8_t *data, size_t n);
-
-char *hc_gets(struct hc_stream *s, struct hc_malloc *malloc);
-char hc_getc(struct hc_stream *s);
-size_t hc_putc(struct hc_stream *s, char data);
-size_t hc_puts(struct hc_stream *s, const char *data);
-
-size_t hc_vprintf(struct hc_stream *s,
-		  const char *spec,
-		  va_list args);
-
-size_t hc_printf(struct hc_stream *s, const char *spec, ...);
-
-void hc_stream_deinit(struct hc_stream *s);
-
-struct hc_file_stream_opts {
-  bool close_file;
-};
-
-struct hc_file_stream {
-  struct hc_stream stream;
-  FILE *file;
-  struct hc_file_stream_opts opts;
-};
-
-#define hc_file_stream_init(s, f, ...)				\
-  _hc_file_stream_init(s, f, (struct hc_file_stream_opts){	\
-      .close_file = false,					\
-      ##__VA_ARGS__						\
-    })
-
-extern struct hc_stream hc_file_stream;
-
-struct hc_file_stream *_hc_file_stream_init(struct hc_file_stream *s,
-					    FILE *file,
-					    struct hc_file_stream_opts opts);
-
-struct hc_stream *hc_stdout();
-
-struct hc_memory_stream {
-  struct hc_stream stream;
-  struct hc_vector data;
-  size_t rpos;
-};
-
-extern struct hc_stream hc_memory_stream;
-
-struct hc_memory_stream *hc_memory_stream_init(struct hc_memory_stream *s,
-					       struct hc_malloc *malloc);
-
-const char *hc_memory_stream_string(struct hc_memory_stream *s);
-
-#endif
+#ifndef HACKTICAL_STREAM1_H
+#define HACKTICAL_STREAM1_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/uio.h>
+
+#include "vector/vector.h"
+
+#define HC_PRINTF_BUFFER_SIZE 256
+
+struct hc_stream {  
+  size_t (*read)(struct hc_stream *, uint8_t *, size_t);
+  size_t (*write)(struct hc_stream *, const uint8_t *, size_t);
+  size_t (*writev)(struct hc_stream *, const struct iovec *, int);
+  const uint8_t *(*acquire_read)(struct hc_stream *, size_t *);
+  void (*release_read)(struct hc_stream *, size_t);
+  uint8_t *(*acquire_write)(struct hc_stream *, size_t);
+  void (*commit_write)(struct hc_stream *, size_t);
+  int (*fd)(struct hc_stream *);
+  void (*deinit)(struct hc_stream *);
+};
+
+size_t hc_read(struct hc_stream *s, uint8_t *data, size_t n);
+size_t hc_write(struct hc_stream *s, const uint8_t *data, size_t n);
+size_t hc_writev(struct hc_stream *s, const struct iovec *iov, int n);
+bool hc_stream_view(struct hc_stream *s, const uint8_t **data, size_t *n);
+
+const uint8_t *hc_acquire_read(struct hc_stream *s, size_t *n);
+void hc_release_read(struct hc_stream *s, size_t n);
+uint8_t *hc_acquire_write(struct hc_stream *s, size_t n);
+void hc_commit_write(struct hc_stream *s, size_t n);
+int hc_stream_fd(struct hc_stream *s);
+
+char *hc_gets(struct hc_stream *s, struct hc_malloc *malloc);
+char hc_getc(struct hc_stream *s);
+size_t hc_putc(struct hc_stream *s, char data);
+size_t hc_puts(struct hc_stream *s, const char *data);
+
+size_t hc_put_int(struct hc_stream *s, int64_t data);
+size_t hc_put_uint(struct hc_stream *s, uint64_t data);
+size_t hc_put_decimal(struct hc_stream *s, int64_t data, uint8_t exp);
+
+size_t hc_vprintf(struct hc_stream *s,
+		  const char *spec,
+		  va_list args);
+
+size_t hc_printf(struct hc_stream *s, const char *spec, ...);
+
+void hc_stream_deinit(struct hc_stream *s);
+
+struct hc_file_stream_opts {
+  bool close_file;
+};
+
+struct hc_file_stream {
+  struct hc_stream stream;
+  FILE *file;
+  struct hc_file_stream_opts opts;
+};
+
+#define hc_file_stream_init(s, f, ...)				\
+  _hc_file_stream_init(s, f, (struct hc_file_stream_opts){	\
+      .close_file = false,					\
+      ##__VA_ARGS__						\
+    })
+
+extern struct hc_stream hc_file_stream;
+
+struct hc_file_stream *_hc_file_stream_init(struct hc_file_stream *s,
+					    FILE *file,
+					    struct hc_file_stream_opts opts);
+
+struct hc_stream *hc_stdout();
+
+struct hc_memory_stream {
+  struct hc_stream stream;
+  struct hc_vector data;
+  size_t rpos;
+};
+
+extern struct hc_stream hc_memory_stream;
+
+struct hc_memory_stream *hc_memory_stream_init(struct hc_memory_stream *s,
+					       struct hc_malloc *malloc);
+
+const char *hc_memory_stream_string(struct hc_memory_stream *s);
+
+#endif
@@ -1,11 +1,94 @@
-#include <assert.h>
-#include <string.h>
-#include "stream1.h"
-
-void stream1_tests() {
-  struct hc_memory_stream s;
-  hc_memory_stream_init(&s, &hc_malloc_default);
-  hc_defer(hc_stream_deinit(&s.stream));
-  hc_printf(&s.stream, "%s%d", "foo", 42);
-  assert(strcmp("foo42", hc_memory_stream_string(&s)) == 0);
-}
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stream1.h"
+
+static void memory_tests() {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&s.stream));
+  hc_printf(&s.stream, "%s%d", "foo", 42);
+  assert(strcmp("foo42", hc_memory_stream_string(&s)) == 0);
+
+  const uint8_t *data = NULL;
+  size_t n = 0;
+  assert(hc_stream_view(&s.stream, &data, &n));
+  assert(n == 6 && data == s.data.start);
+}
+
+static void acquire_tests() {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&s.stream));
+  uint8_t *dst = hc_acquire_write(&s.stream, 3);
+  memcpy(dst, "foo", 3);
+  hc_commit_write(&s.stream, 3);
+
+  size_t n = 0;
+  const uint8_t *src = hc_acquire_read(&s.stream, &n);
+  assert(n == 3 && memcmp(src, "foo", 3) == 0);
+  hc_release_read(&s.stream, 2);
+  assert(hc_getc(&s.stream) == 'o');
+}
+
+static void put_tests() {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&s.stream));
+  hc_put_int(&s.stream, -42);
+  hc_putc(&s.stream, ' ');
+  hc_put_uint(&s.stream, UINT64_MAX);
+  hc_putc(&s.stream, ' ');
+  hc_put_decimal(&s.stream, -5, 2);
+  hc_putc(&s.stream, ' ');
+  hc_put_decimal(&s.stream, 12345, 3);
+  
+  assert(strcmp("-42 18446744073709551615 -0.05 12.345",
+		hc_memory_stream_string(&s)) == 0);
+}
+
+static void printf_tests() {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&s.stream));
+  char data[HC_PRINTF_BUFFER_SIZE * 2];
+  memset(data, 'x', sizeof(data) - 1);
+  data[sizeof(data) - 1] = 0;
+  hc_printf(&s.stream, "%s", data);
+  assert(strcmp(data, hc_memory_stream_string(&s)) == 0);
+}
+
+static void gets_test(struct hc_stream *s) {
+  char *line = hc_gets(s, &hc_malloc_default);
+  assert(strcmp(line, "foo\n") == 0);
+  free(line);
+  line = hc_gets(s, &hc_malloc_default);
+  assert(strcmp(line, "bar") == 0);
+  free(line);
+  assert(!hc_gets(s, &hc_malloc_default));
+}
+
+static void gets_tests() {
+  {
+    struct hc_memory_stream s;
+    hc_memory_stream_init(&s, &hc_malloc_default);
+    hc_defer(hc_stream_deinit(&s.stream));
+    hc_puts(&s.stream, "foo\nbar");
+    gets_test(&s.stream);
+  }
+
+  struct hc_file_stream s;
+  hc_file_stream_init(&s, tmpfile(), .close_file = true);
+  hc_defer(hc_stream_deinit(&s.stream));
+  hc_puts(&s.stream, "foo\nbar");
+  rewind(s.file);
+  gets_test(&s.stream);
+}
+
+void stream1_tests() {
+  memory_tests();
+  acquire_tests();
+  put_tests();
+  printf_tests();
+  gets_tests();
+}
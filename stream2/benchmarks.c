@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chrono/chrono.h"
+#include "stream2.h"
+
+#define DATA_SIZE (16 * 1024 * 1024)
+
+static void run_raw(const uint8_t *data) {
+  FILE *f = tmpfile();
+  struct hc_file_stream s;
+  hc_file_stream_init(&s, f, .close_file = true);
+  hc_time_t t = hc_now();
+  hc_write(&s.stream, data, DATA_SIZE);
+  fflush(f);
+  hc_time_print(&t, "raw: ");
+  printf("raw size: %ld\n", ftell(f));
+  hc_stream_deinit(&s.stream);
+}
+
+static void run_compress(const uint8_t *data) {
+  FILE *f = tmpfile();
+  struct hc_file_stream fs;
+  hc_file_stream_init(&fs, f, .close_file = true);
+  hc_time_t t = hc_now();
+
+  {
+    struct hc_compress_stream s;
+    hc_compress_stream_init(&s, &fs.stream);
+    hc_write(&s.stream, data, DATA_SIZE);
+    hc_stream_deinit(&s.stream);
+  }
+  
+  fflush(f);
+  hc_time_print(&t, "compress: ");
+  printf("compressed size: %ld\n", ftell(f));
+  rewind(f);
+  t = hc_now();
+  
+  {
+    struct hc_decompress_stream s;
+    hc_decompress_stream_init(&s, &fs.stream);
+    uint8_t buffer[4096];
+    while (hc_read(&s.stream, buffer, sizeof(buffer)));
+    hc_stream_deinit(&s.stream);
+  }
+
+  hc_time_print(&t, "decompress: ");
+  hc_stream_deinit(&fs.stream);
+}
+
+static void run_gets(const uint8_t *data) {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_write(&s.stream, data, DATA_SIZE);
+  hc_time_t t = hc_now();
+
+  for (char *line; (line = hc_gets(&s.stream, &hc_malloc_default));) {
+    free(line);
+  }
+  
+  hc_time_print(&t, "gets: ");
+  hc_stream_deinit(&s.stream);
+}
+
+static void run_lines(const uint8_t *data) {
+  struct hc_memory_stream s;
+  hc_memory_stream_init(&s, &hc_malloc_default);
+  hc_write(&s.stream, data, DATA_SIZE);
+  struct hc_line_reader r;
+  hc_line_reader_init(&r, &s.stream);
+  hc_time_t t = hc_now();
+  const uint8_t *line = NULL;
+  size_t n = 0;
+  
+  while (hc_line_reader_next(&r, &line, &n));
+  hc_time_print(&t, "lines: ");
+  hc_line_reader_deinit(&r);
+  hc_stream_deinit(&s.stream);
+}
+
+void stream2_benchmarks() {
+  // Something resembling log output
+  uint8_t *data = malloc(DATA_SIZE);
+  struct hc_memory_stream ms;
+  hc_memory_stream_init(&ms, &hc_malloc_default);
+
+  for (int i = 0; ms.data.length < DATA_SIZE; i++) {
+    hc_printf(&ms.stream,
+	      "level=info ts=%d id=%d msg=\"request done\"\n",
+	      1700000000 + i / 10, rand() % 100000);
+  }
+  
+  memcpy(data, ms.data.start, DATA_SIZE);
+  hc_stream_deinit(&ms.stream);
+  run_raw(data);
+  run_compress(data);
+  run_gets(data);
+  run_lines(data);
+  free(data);
+}
@@ -0,0 +1,2084 @@
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "error/error.h"
+#include "list/list.h"
+#include "macro/macro.h"
+#include "malloc1/malloc1.h"
+#include "stream2.h"
+
+/* FD */
+
+#define FD_IOV_MAX 64
+
+static void fd_writev(struct hc_fd_stream *s, struct iovec *iov, int n) {
+  while (n) {
+    const ssize_t r = writev(s->fd, iov, n);
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      hc_throw("Failed writing to fd %d: %d", s->fd, errno);
+    }
+
+    size_t rest = r;
+    for (; n && rest >= iov->iov_len; rest -= iov->iov_len, iov++, n--);
+
+    if (n) {
+      iov->iov_base = (uint8_t *)iov->iov_base + rest;
+      iov->iov_len -= rest;
+    }
+  }
+}
+
+static void fd_pwrite(struct hc_fd_stream *s,
+		      const uint8_t *data,
+		      size_t n,
+		      off_t offset) {
+  while (n) {
+    const ssize_t r = pwrite(s->fd, data, n, offset);
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      hc_throw("Failed writing to fd %d: %d", s->fd, errno);
+    }
+
+    data += r;
+    n -= r;
+    offset += r;
+  }
+}
+
+static size_t fd_pread(struct hc_fd_stream *s,
+		       uint8_t *data,
+		       const size_t n,
+		       off_t offset) {
+  size_t result = 0;
+
+  while (result < n) {
+    const ssize_t r = pread(s->fd, data + result, n - result, offset);
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      hc_throw("Failed reading from fd %d: %d", s->fd, errno);
+    }
+
+    if (!r) { break; }
+    result += r;
+    offset += r;
+  }
+
+  return result;
+}
+
+static void direct_flush(struct hc_fd_stream *s, const bool partial) {
+  const size_t n = s->length - s->length % HC_FD_ALIGN;
+
+  if (n) {
+    fd_pwrite(s, s->buffer, n, s->offset);
+    s->offset += n;
+    s->length -= n;
+    memmove(s->buffer, s->buffer + n, s->length);
+  }
+
+  if (partial && s->length) {
+    // The tail is padded to a full block and kept in the buffer,
+    // to be rewritten in place by the next flush.
+    memset(s->buffer + s->length, 0, HC_FD_ALIGN - s->length);
+    fd_pwrite(s, s->buffer, HC_FD_ALIGN, s->offset);
+
+    if (ftruncate(s->fd, s->offset + s->length) == -1) {
+      hc_throw("Failed truncating fd %d: %d", s->fd, errno);
+    }
+  }
+}
+
+void hc_fd_stream_flush(struct hc_fd_stream *s) {
+  if (s->opts.direct) {
+    direct_flush(s, true);
+  } else if (s->length) {
+    struct iovec iov = {s->buffer, s->length};
+    fd_writev(s, &iov, 1);
+    s->length = 0;
+  }
+}
+
+static size_t direct_fill(struct hc_fd_stream *s) {
+  if (s->rpos == s->rlength) {
+    // A partial block means we already hit the end.
+    if (s->offset % HC_FD_ALIGN) { return 0; }
+    s->rpos = 0;
+    s->rlength = fd_pread(s, s->buffer, s->opts.buffer_size, s->offset);
+    s->offset += s->rlength;
+  }
+
+  return s->rlength - s->rpos;
+}
+
+static size_t direct_read(struct hc_fd_stream *s,
+			  uint8_t *data,
+			  const size_t n) {
+  size_t result = 0;
+
+  while (result < n) {
+    if (!direct_fill(s)) { break; }
+    const size_t m = hc_min(n - result, s->rlength - s->rpos);
+    memcpy(data + result, s->buffer + s->rpos, m);
+    s->rpos += m;
+    result += m;
+  }
+
+  return result;
+}
+
+static size_t fd_read(struct hc_stream *_s, uint8_t *data, const size_t n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+
+  if (s->opts.direct) {
+    assert(!s->length);
+    return direct_read(s, data, n);
+  }
+
+  hc_fd_stream_flush(s);
+  size_t result = 0;
+
+  while (result < n) {
+    const ssize_t r = read(s->fd, data + result, n - result);
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      hc_throw("Failed reading from fd %d: %d", s->fd, errno);
+    }
+
+    if (!r) { break; }
+    result += r;
+  }
+
+  return result;
+}
+
+static size_t fd_write(struct hc_stream *_s,
+		       const uint8_t *data,
+		       const size_t n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+  const size_t size = s->opts.buffer_size;
+
+  if (s->length + n <= size) {
+    memcpy(s->buffer + s->length, data, n);
+    s->length += n;
+    return n;
+  }
+
+  if (s->opts.direct) {
+    for (size_t rest = n; rest;) {
+      const size_t m = hc_min(rest, size - s->length);
+      memcpy(s->buffer + s->length, data, m);
+      s->length += m;
+      data += m;
+      rest -= m;
+      if (s->length == size) { direct_flush(s, false); }
+    }
+
+    return n;
+  }
+
+  // Buffered data and the new write go out in a single call.
+  struct iovec iov[2] = {{s->buffer, s->length}, {(void *)data, n}};
+  fd_writev(s, iov, 2);
+  s->length = 0;
+  return n;
+}
+
+static size_t fd_write_iov(struct hc_stream *_s,
+			   const struct iovec *iov,
+			   const int n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+  size_t result = 0;
+  for (int i = 0; i < n; i++) { result += iov[i].iov_len; }
+
+  if (s->opts.direct || s->length + result <= s->opts.buffer_size) {
+    for (int i = 0; i < n; i++) {
+      fd_write(_s, iov[i].iov_base, iov[i].iov_len);
+    }
+
+    return result;
+  }
+
+  // Writes are split into batches, since writev() refuses more than
+  // IOV_MAX buffers; buffered data goes out with the first one.
+  struct iovec v[FD_IOV_MAX];
+  v[0] = (struct iovec){s->buffer, s->length};
+  
+  for (int i = 0, j = 1; i < n; j = 0) {
+    const int m = hc_min(n - i, FD_IOV_MAX - j);
+    memcpy(v + j, iov + i, m * sizeof(struct iovec));
+    fd_writev(s, v, j + m);
+    i += m;
+  }
+  
+  s->length = 0;
+  return result;
+}
+
+static const uint8_t *fd_acquire_read(struct hc_stream *_s, size_t *n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+  assert(s->opts.direct && !s->length);
+  *n = direct_fill(s);
+  return s->buffer + s->rpos;
+}
+
+static void fd_release_read(struct hc_stream *_s, const size_t n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+  assert(s->rpos + n <= s->rlength);
+  s->rpos += n;
+}
+
+static uint8_t *fd_acquire_write(struct hc_stream *_s, const size_t n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+
+  if (s->length + n > s->opts.buffer_size) {
+    if (s->opts.direct) {
+      direct_flush(s, false);
+    } else {
+      hc_fd_stream_flush(s);
+    }
+  }
+
+  return (s->length + n > s->opts.buffer_size)
+    ? NULL
+    : s->buffer + s->length;
+}
+
+static void fd_commit_write(struct hc_stream *_s, const size_t n) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+  assert(s->length + n <= s->opts.buffer_size);
+  s->length += n;
+}
+
+static int fd_descriptor(struct hc_stream *_s) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+
+  // Direct I/O keeps its own position and alignment rules.
+  if (s->opts.direct) {
+    return -1;
+  }
+  
+  hc_fd_stream_flush(s);
+  return s->fd;
+}
+
+static void fd_deinit(struct hc_stream *_s) {
+  struct hc_fd_stream *s = hc_baseof(_s, struct hc_fd_stream, stream);
+  hc_fd_stream_flush(s);
+  free(s->buffer);
+
+  if (s->opts.close_fd) {
+    if (close(s->fd) == -1) {
+      hc_throw("Failed closing fd %d: %d", s->fd, errno);
+    }
+
+    s->fd = -1;
+  }
+}
+
+struct hc_fd_stream *_hc_fd_stream_init(struct hc_fd_stream *s,
+					const int fd,
+					struct hc_fd_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .read          = fd_read,
+    .write         = fd_write,
+    .writev        = fd_write_iov,
+    .acquire_write = fd_acquire_write,
+    .commit_write  = fd_commit_write,
+    .fd            = fd_descriptor,
+    .deinit        = fd_deinit,
+  };
+
+  // Reads are only buffered in direct mode.
+  if (opts.direct) {
+    s->stream.acquire_read = fd_acquire_read;
+    s->stream.release_read = fd_release_read;
+  }
+
+  s->fd = fd;
+
+  if (opts.direct) {
+    const int flags = fcntl(fd, F_GETFL);
+
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_DIRECT) == -1) {
+      hc_throw("Failed enabling direct I/O for fd %d: %d", fd, errno);
+    }
+
+    opts.buffer_size = (opts.buffer_size + HC_FD_ALIGN - 1) /
+      HC_FD_ALIGN * HC_FD_ALIGN;
+
+    if (posix_memalign((void **)&s->buffer,
+		       HC_FD_ALIGN,
+		       opts.buffer_size)) {
+      hc_throw(HC_NO_MEMORY);
+    }
+  } else {
+    s->buffer = malloc(opts.buffer_size);
+  }
+
+  s->opts = opts;
+  s->length = s->rpos = s->rlength = 0;
+  s->offset = 0;
+  return s;
+}
+
+size_t hc_fd_stream_pread(struct hc_fd_stream *s,
+			  uint8_t *data,
+			  const size_t n,
+			  const off_t offset) {
+  hc_fd_stream_flush(s);
+  return fd_pread(s, data, n, offset);
+}
+
+size_t hc_fd_stream_pwrite(struct hc_fd_stream *s,
+			   const uint8_t *data,
+			   const size_t n,
+			   const off_t offset) {
+  hc_fd_stream_flush(s);
+  fd_pwrite(s, data, n, offset);
+  return n;
+}
+
+/* MMap */
+
+static size_t mmap_read(struct hc_stream *_s, uint8_t *data, size_t n) {
+  struct hc_mmap_stream *s = hc_baseof(_s, struct hc_mmap_stream, stream);
+  n = hc_min(n, s->length - s->rpos);
+  memcpy(data, s->data + s->rpos, n);
+  s->rpos += n;
+  return n;
+}
+
+static const uint8_t *mmap_acquire_read(struct hc_stream *_s, size_t *n) {
+  struct hc_mmap_stream *s = hc_baseof(_s, struct hc_mmap_stream, stream);
+  *n = s->length - s->rpos;
+  return s->data + s->rpos;
+}
+
+static void mmap_release_read(struct hc_stream *_s, const size_t n) {
+  struct hc_mmap_stream *s = hc_baseof(_s, struct hc_mmap_stream, stream);
+  assert(s->rpos + n <= s->length);
+  s->rpos += n;
+}
+
+static void mmap_deinit(struct hc_stream *_s) {
+  struct hc_mmap_stream *s = hc_baseof(_s, struct hc_mmap_stream, stream);
+
+  if (munmap(s->data, s->size) == -1) {
+    hc_throw("Failed unmapping file: %d", errno);
+  }
+}
+
+struct hc_mmap_stream *_hc_mmap_stream_init(struct hc_mmap_stream *s,
+					    const int fd,
+					    const struct hc_mmap_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .read         = mmap_read,
+    .acquire_read = mmap_acquire_read,
+    .release_read = mmap_release_read,
+    .deinit       = mmap_deinit,
+  };
+
+  struct stat st;
+
+  if (fstat(fd, &st) == -1) {
+    hc_throw("Failed reading size of fd %d: %d", fd, errno);
+  }
+
+  // An anonymous mapping with at least one page to spare is reserved
+  // first and the file mapped on top, which guarantees that the data
+  // is always followed by zeros and may be parsed as a string.
+  const size_t page = sysconf(_SC_PAGESIZE);
+  s->length = st.st_size;
+  s->size = (s->length / page + 1) * page;
+  s->rpos = 0;
+
+  s->data = mmap(NULL,
+		 s->size,
+		 PROT_READ,
+		 MAP_PRIVATE | MAP_ANONYMOUS,
+		 -1,
+		 0);
+
+  if (s->data == MAP_FAILED) {
+    hc_throw("Failed reserving memory: %d", errno);
+  }
+
+  if (s->length && mmap(s->data,
+			s->length,
+			PROT_READ,
+			MAP_PRIVATE | MAP_FIXED,
+			fd,
+			0) == MAP_FAILED) {
+    munmap(s->data, s->size);
+    hc_throw("Failed mapping fd %d: %d", fd, errno);
+  }
+
+  // Advice is only a hint, failing to follow it is not an error.
+  if (s->length && opts.sequential) {
+    madvise(s->data, s->length, MADV_SEQUENTIAL);
+  }
+
+  if (s->length && opts.willneed) {
+    madvise(s->data, s->length, MADV_WILLNEED);
+  }
+  
+  return s;
+}
+
+/* URing */
+
+struct hc_uring_slot {
+  uint8_t *data;
+  size_t length, done, rpos;
+  off_t offset;
+  bool busy, eof, read, queued;
+  int error;
+  struct hc_list queue;
+};
+
+struct hc_uring {
+  int fd;
+  unsigned *sq_tail, *sq_mask, *sq_array;
+  unsigned *cq_head, *cq_tail, *cq_mask;
+  struct io_uring_sqe *sqes;
+  struct io_uring_cqe *cqes;
+  uint8_t *sq_ring, *cq_ring;
+  size_t sq_size, cq_size, sqes_size;
+  bool fixed;
+};
+
+struct hc_uring_pool {
+  pthread_mutex_t lock;
+  pthread_cond_t ready, done;
+  struct hc_list jobs;
+  size_t thread_count;
+  bool stop;
+  pthread_t threads[];
+};
+
+static void *uring_map(const int fd, const size_t size, const off_t offset) {
+  void *p = mmap(NULL,
+		 size,
+		 PROT_READ | PROT_WRITE,
+		 MAP_SHARED | MAP_POPULATE,
+		 fd,
+		 offset);
+
+  return (p == MAP_FAILED) ? NULL : p;
+}
+
+static void uring_free(struct hc_uring *u) {
+  if (u->sqes) { munmap(u->sqes, u->sqes_size); }
+
+  if (u->cq_ring && u->cq_ring != u->sq_ring) {
+    munmap(u->cq_ring, u->cq_size);
+  }
+
+  if (u->sq_ring) { munmap(u->sq_ring, u->sq_size); }
+  close(u->fd);
+  free(u);
+}
+
+static struct hc_uring *uring_new(struct hc_uring_stream *s) {
+  struct io_uring_params p = {0};
+  const int fd = syscall(__NR_io_uring_setup, s->opts.buffer_count, &p);
+
+  if (fd == -1) {
+    return NULL;
+  }
+
+  struct hc_uring *u = malloc(sizeof(struct hc_uring));
+  u->fd = fd;
+  u->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  u->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    u->sq_size = u->cq_size = hc_max(u->sq_size, u->cq_size);
+  }
+
+  u->sq_ring = uring_map(fd, u->sq_size, IORING_OFF_SQ_RING);
+
+  u->cq_ring = (!u->sq_ring || (p.features & IORING_FEAT_SINGLE_MMAP))
+    ? u->sq_ring
+    : uring_map(fd, u->cq_size, IORING_OFF_CQ_RING);
+
+  u->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  u->sqes = u->cq_ring ? uring_map(fd, u->sqes_size, IORING_OFF_SQES) : NULL;
+
+  // Mapping may fail because of memory limits, in which case the thread
+  // pool takes over.
+  if (!u->sqes) {
+    uring_free(u);
+    return NULL;
+  }
+  
+  u->sq_tail = (unsigned *)(u->sq_ring + p.sq_off.tail);
+  u->sq_mask = (unsigned *)(u->sq_ring + p.sq_off.ring_mask);
+  u->sq_array = (unsigned *)(u->sq_ring + p.sq_off.array);
+  u->cq_head = (unsigned *)(u->cq_ring + p.cq_off.head);
+  u->cq_tail = (unsigned *)(u->cq_ring + p.cq_off.tail);
+  u->cq_mask = (unsigned *)(u->cq_ring + p.cq_off.ring_mask);
+  u->cqes = (struct io_uring_cqe *)(u->cq_ring + p.cq_off.cqes);
+
+  // Registering buffers may fail because of memory lock limits,
+  // in which case we fall back to regular reads and writes.
+  struct iovec iov[s->opts.buffer_count];
+
+  for (size_t i = 0; i < s->opts.buffer_count; i++) {
+    iov[i] = (struct iovec){s->slots[i].data, s->opts.buffer_size};
+  }
+  
+  u->fixed = syscall(__NR_io_uring_register,
+		     fd,
+		     IORING_REGISTER_BUFFERS,
+		     iov,
+		     s->opts.buffer_count) == 0;
+  
+  return u;
+}
+
+static void uring_queue(struct hc_uring_stream *s,
+			struct hc_uring_slot *slot) {
+  struct hc_uring *u = s->uring;
+  const unsigned tail = *u->sq_tail;
+  const unsigned i = tail & *u->sq_mask;
+  const size_t si = slot - s->slots;
+  struct io_uring_sqe *sqe = u->sqes + i;
+  memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+  sqe->opcode = slot->read
+    ? (u->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ)
+    : (u->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE);
+
+  sqe->fd = s->fd;
+  sqe->addr = (uintptr_t)(slot->data + slot->done);
+  sqe->len = slot->length - slot->done;
+  sqe->off = slot->offset + slot->done;
+  sqe->buf_index = si;
+  sqe->user_data = si;
+  u->sq_array[i] = i;
+  __atomic_store_n(u->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static void uring_enter(struct hc_uring_stream *s, const bool wait) {
+  const int r = syscall(__NR_io_uring_enter,
+			s->uring->fd,
+			s->queued,
+			wait ? 1 : 0,
+			wait ? IORING_ENTER_GETEVENTS : 0,
+			NULL,
+			0);
+
+  if (r == -1) {
+    if (errno == EINTR) { return; }
+    hc_throw("Failed entering io_uring: %d", errno);
+  }
+
+  s->queued -= r;
+}
+
+static void pool_queue(struct hc_uring_stream *s,
+		       struct hc_uring_slot *slot) {
+  struct hc_uring_pool *p = s->pool;
+  pthread_mutex_lock(&p->lock);
+  hc_list_push_back(&p->jobs, &slot->queue);
+  pthread_mutex_unlock(&p->lock);
+}
+
+static void slot_run(struct hc_uring_stream *s, struct hc_uring_slot *slot) {
+  while (slot->done < slot->length) {
+    uint8_t *const data = slot->data + slot->done;
+    const size_t n = slot->length - slot->done;
+    const off_t offset = slot->offset + slot->done;
+
+    const ssize_t r = slot->read
+      ? pread(s->fd, data, n, offset)
+      : pwrite(s->fd, data, n, offset);
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      slot->error = errno;
+      break;
+    }
+
+    if (!r) {
+      slot->eof = true;
+      break;
+    }
+
+    slot->done += r;
+  }
+}
+
+static void *pool_run(void *arg) {
+  struct hc_uring_stream *s = arg;
+  struct hc_uring_pool *p = s->pool;
+  pthread_mutex_lock(&p->lock);
+  
+  for (;;) {
+    while (!p->stop && hc_list_nil(&p->jobs)) {
+      pthread_cond_wait(&p->ready, &p->lock);
+    }
+    
+    struct hc_list *j = hc_list_pop_front(&p->jobs);
+    if (!j) { break; }
+    pthread_mutex_unlock(&p->lock);
+    struct hc_uring_slot *slot = hc_baseof(j, struct hc_uring_slot, queue);
+    slot_run(s, slot);
+    pthread_mutex_lock(&p->lock);
+    slot->busy = false;
+    pthread_cond_broadcast(&p->done);
+  }
+
+  pthread_mutex_unlock(&p->lock);
+  return NULL;
+}
+
+static void pool_new(struct hc_uring_stream *s) {
+  const size_t n = hc_max(s->opts.threads, (size_t)1);
+
+  struct hc_uring_pool *p =
+    malloc(sizeof(struct hc_uring_pool) + n * sizeof(pthread_t));
+
+  pthread_mutex_init(&p->lock, NULL);
+  pthread_cond_init(&p->ready, NULL);
+  pthread_cond_init(&p->done, NULL);
+  hc_list_init(&p->jobs);
+  p->thread_count = n;
+  p->stop = false;
+
+  // Needs to be in place before the threads start.
+  s->pool = p;
+  
+  for (size_t i = 0; i < n; i++) {
+    const int e = pthread_create(p->threads + i, NULL, pool_run, s);
+    if (e) { hc_throw("Failed creating thread: %d", e); }
+  }
+}
+
+static void pool_free(struct hc_uring_pool *p) {
+  pthread_mutex_lock(&p->lock);
+  p->stop = true;
+  pthread_cond_broadcast(&p->ready);
+  pthread_mutex_unlock(&p->lock);
+
+  for (size_t i = 0; i < p->thread_count; i++) {
+    pthread_join(p->threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&p->done);
+  pthread_cond_destroy(&p->ready);
+  pthread_mutex_destroy(&p->lock);
+  free(p);
+}
+
+static void uring_complete(struct hc_uring_stream *s,
+			   struct hc_uring_slot *slot,
+			   const int result) {
+  if (result < 0) {
+    slot->error = -result;
+  } else if (!result) {
+    slot->eof = true;
+  } else if ((slot->done += result) < slot->length) {
+    // Short transfers are resubmitted until done.
+    uring_queue(s, slot);
+    s->queued++;
+    return;
+  }
+
+  slot->busy = false;
+}
+
+static void uring_reap(struct hc_uring_stream *s) {
+  struct hc_uring *u = s->uring;
+  unsigned head = *u->cq_head;
+  const unsigned tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+
+  for (; head != tail; head++) {
+    struct io_uring_cqe *cqe = u->cqes + (head & *u->cq_mask);
+    uring_complete(s, s->slots + cqe->user_data, cqe->res);
+  }
+
+  __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+}
+
+static void uring_submit(struct hc_uring_stream *s) {
+  if (!s->queued) {
+    return;
+  }
+  
+  if (s->uring) {
+    uring_enter(s, false);
+  } else {
+    pthread_mutex_lock(&s->pool->lock);
+    pthread_cond_broadcast(&s->pool->ready);
+    pthread_mutex_unlock(&s->pool->lock);
+    s->queued = 0;
+  }
+}
+
+static void slot_queue(struct hc_uring_stream *s,
+		       struct hc_uring_slot *slot) {
+  slot->busy = slot->queued = true;
+  slot->eof = false;
+  slot->done = slot->rpos = 0;
+
+  if (s->uring) {
+    uring_queue(s, slot);
+  } else {
+    pool_queue(s, slot);
+  }
+
+  if (++s->queued >= s->opts.batch) {
+    uring_submit(s);
+  }
+}
+
+static void slot_check(struct hc_uring_stream *s,
+		       struct hc_uring_slot *slot) {
+  if (slot->error) {
+    const int e = slot->error;
+    slot->error = 0;
+    
+    hc_throw("Failed %s fd %d: %d",
+	     slot->read ? "reading from" : "writing to",
+	     s->fd,
+	     e);
+  }
+}
+
+static void slot_wait(struct hc_uring_stream *s,
+		      struct hc_uring_slot *slot) {
+  if (s->uring) {
+    while (slot->busy) {
+      uring_enter(s, true);
+      uring_reap(s);
+    }
+  } else {
+    uring_submit(s);
+    struct hc_uring_pool *p = s->pool;
+    pthread_mutex_lock(&p->lock);
+
+    while (slot->busy) {
+      pthread_cond_wait(&p->done, &p->lock);
+    }
+    
+    pthread_mutex_unlock(&p->lock);
+  }
+
+  slot_check(s, slot);
+}
+
+bool hc_uring_stream_busy(struct hc_uring_stream *s) {
+  hc_uring_stream_submit(s);
+  if (s->uring) { uring_reap(s); }
+  if (s->pool) { pthread_mutex_lock(&s->pool->lock); }
+  bool result = false;
+  
+  for (size_t i = 0; i < s->opts.buffer_count; i++) {
+    result |= s->slots[i].busy;
+  }
+
+  if (s->pool) { pthread_mutex_unlock(&s->pool->lock); }
+  return result;
+}
+
+static void wait_all(struct hc_uring_stream *s) {
+  for (size_t i = 0; i < s->opts.buffer_count; i++) {
+    slot_wait(s, s->slots + i);
+  }
+}
+
+// Queues the current buffer without waiting, partly filled buffers are
+// pushed on submit.
+
+static void slot_push(struct hc_uring_stream *s) {
+  struct hc_uring_slot *slot = s->slots + s->next;
+
+  if (slot->queued || !slot->length) {
+    return;
+  }
+
+  slot->read = false;
+  slot->offset = s->offset;
+  s->offset += slot->length;
+  slot_queue(s, slot);
+  s->next = (s->next + 1) % s->opts.buffer_count;
+}
+
+// Waits for the current buffer to finish its previous transfer before
+// it's reused.
+
+static struct hc_uring_slot *slot_take(struct hc_uring_stream *s) {
+  struct hc_uring_slot *slot = s->slots + s->next;
+
+  if (slot->queued) {
+    slot_wait(s, slot);
+    slot->queued = false;
+    slot->length = 0;
+  }
+
+  return slot;
+}
+
+void hc_uring_stream_submit(struct hc_uring_stream *s) {
+  if (!s->reading) {
+    slot_push(s);
+  }
+
+  uring_submit(s);
+}
+
+void hc_uring_stream_flush(struct hc_uring_stream *s) {
+  hc_uring_stream_submit(s);
+  wait_all(s);
+
+  if (!s->reading) {
+    for (size_t i = 0; i < s->opts.buffer_count; i++) {
+      s->slots[i].queued = false;
+      s->slots[i].length = 0;
+    }
+  }
+}
+
+static size_t uring_write(struct hc_stream *_s,
+			  const uint8_t *data,
+			  const size_t n) {
+  struct hc_uring_stream *s = hc_baseof(_s, struct hc_uring_stream, stream);
+  assert(!s->reading);
+  const size_t size = s->opts.buffer_size;
+  
+  for (size_t rest = n; rest;) {
+    struct hc_uring_slot *slot = slot_take(s);
+    const size_t m = hc_min(rest, size - slot->length);
+    memcpy(slot->data + slot->length, data, m);
+    slot->length += m;
+    data += m;
+    rest -= m;
+    if (slot->length == size) { slot_push(s); }
+  }
+
+  return n;
+}
+
+static void read_ahead(struct hc_uring_stream *s,
+		       struct hc_uring_slot *slot) {
+  slot->read = true;
+  slot->length = s->opts.buffer_size;
+  slot->offset = s->offset;
+  s->offset += slot->length;
+  slot_queue(s, slot);
+}
+
+static size_t uring_read(struct hc_stream *_s, uint8_t *data, const size_t n) {
+  struct hc_uring_stream *s = hc_baseof(_s, struct hc_uring_stream, stream);
+
+  if (!s->reading) {
+    // Reading starts by requesting as many buffers as we have, once
+    // pending writes are done.
+    assert(!s->slots[s->next].length || s->slots[s->next].queued);
+    wait_all(s);
+    s->reading = true;
+    
+    for (size_t i = 0; i < s->opts.buffer_count; i++) {
+      read_ahead(s, s->slots + (s->next + i) % s->opts.buffer_count);
+    }
+  }
+  
+  size_t result = 0;
+  
+  while (result < n) {
+    struct hc_uring_slot *slot = s->slots + s->next;
+    slot_wait(s, slot);
+    const size_t m = hc_min(n - result, slot->done - slot->rpos);
+    memcpy(data + result, slot->data + slot->rpos, m);
+    slot->rpos += m;
+    result += m;
+
+    if (slot->rpos == slot->done) {
+      if (slot->eof) { break; }
+      read_ahead(s, slot);
+      s->next = (s->next + 1) % s->opts.buffer_count;
+    }
+  }
+
+  return result;
+}
+
+static void uring_deinit(struct hc_stream *_s) {
+  struct hc_uring_stream *s = hc_baseof(_s, struct hc_uring_stream, stream);
+  hc_uring_stream_flush(s);
+  
+  if (s->uring) {
+    uring_free(s->uring);
+  } else {
+    pool_free(s->pool);
+  }
+
+  for (size_t i = 0; i < s->opts.buffer_count; i++) {
+    free(s->slots[i].data);
+  }
+
+  free(s->slots);
+  
+  if (s->opts.close_fd && close(s->fd) == -1) {
+    hc_throw("Failed closing fd %d: %d", s->fd, errno);
+  }
+}
+
+struct hc_uring_stream *_hc_uring_stream_init(struct hc_uring_stream *s,
+					      const int fd,
+					      const struct hc_uring_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .read   = uring_read,
+    .write  = uring_write,
+    .deinit = uring_deinit,
+  };
+
+  s->fd = fd;
+  s->opts = opts;
+  s->slots = calloc(opts.buffer_count, sizeof(struct hc_uring_slot));
+
+  for (size_t i = 0; i < opts.buffer_count; i++) {
+    if (posix_memalign((void **)&s->slots[i].data,
+		       HC_FD_ALIGN,
+		       opts.buffer_size)) {
+      hc_throw(HC_NO_MEMORY);
+    }
+  }
+
+  s->next = s->queued = 0;
+  s->reading = false;
+  const off_t offset = lseek(fd, 0, SEEK_CUR);
+  s->offset = (offset == -1) ? 0 : offset;
+  s->uring = opts.force_threads ? NULL : uring_new(s);
+  s->pool = NULL;
+  if (!s->uring) { pool_new(s); }
+  return s;
+}
+
+/* Compress */
+
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_HEADER_SIZE 8
+
+static uint32_t lz_read32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint32_t lz_hash(const uint32_t v) {
+  return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static uint8_t *lz_put_length(uint8_t *op, size_t n) {
+  for (; n >= 255; n -= 255) { *op++ = 255; }
+  *op++ = n;
+  return op;
+}
+
+static uint8_t *lz_put_literals(uint8_t *op,
+				const uint8_t *data,
+				const size_t n,
+				const uint8_t match) {
+  *op++ = (hc_min(n, (size_t)15) << 4) | match;
+  if (n >= 15) { op = lz_put_length(op, n - 15); }
+  memcpy(op, data, n);
+  return op + n;
+}
+
+size_t hc_lz_compress(const uint8_t *in, const size_t n, uint8_t *out) {
+  uint32_t table[1 << LZ_HASH_BITS] = {0};
+  const uint8_t *ip = in, *anchor = in, *const end = in + n;
+  const uint8_t *const limit = (n < LZ_MIN_MATCH) ? in : end - LZ_MIN_MATCH;
+  uint8_t *op = out;
+
+  while (ip < limit) {
+    const uint32_t v = lz_read32(ip);
+    const uint32_t h = lz_hash(v);
+    const uint8_t *ref = in + table[h];
+    table[h] = ip - in;
+
+    if (ref >= ip || ip - ref > LZ_MAX_OFFSET || lz_read32(ref) != v) {
+      // Skip faster through data that doesn't compress.
+      ip += 1 + ((ip - anchor) >> 6);
+      continue;
+    }
+
+    const uint8_t *mp = ip + LZ_MIN_MATCH;
+    for (const uint8_t *rp = ref + LZ_MIN_MATCH; mp < end && *mp == *rp; mp++, rp++);
+    const size_t offset = ip - ref, m = mp - ip - LZ_MIN_MATCH;
+    op = lz_put_literals(op, anchor, ip - anchor, hc_min(m, (size_t)15));
+    *op++ = offset & 0xff;
+    *op++ = offset >> 8;
+    if (m >= 15) { op = lz_put_length(op, m - 15); }
+    ip = anchor = mp;
+  }
+
+  // The last sequence consists of literals only.
+  op = lz_put_literals(op, anchor, end - anchor, 0);
+  return op - out;
+}
+
+static size_t lz_get_length(const uint8_t **ip, const uint8_t *end) {
+  size_t n = 0;
+  
+  for (;;) {
+    if (*ip == end) { hc_throw("Invalid compressed data"); }
+    const uint8_t v = *(*ip)++;
+    n += v;
+    if (v != 255) { break; }
+  }
+
+  return n;
+}
+
+size_t hc_lz_decompress(const uint8_t *in,
+			const size_t n,
+			uint8_t *out,
+			const size_t out_n) {
+  const uint8_t *ip = in, *const ie = in + n;
+  uint8_t *op = out, *const oe = out + out_n;
+
+  for (;;) {
+    if (ip == ie) { hc_throw("Invalid compressed data"); }
+    const uint8_t token = *ip++;
+    size_t ln = token >> 4;
+    if (ln == 15) { ln += lz_get_length(&ip, ie); }
+
+    if (ln > ie - ip || ln > oe - op) {
+      hc_throw("Invalid compressed data");
+    }
+
+    memcpy(op, ip, ln);
+    op += ln;
+    ip += ln;
+    if (ip == ie) { break; }
+    if (ie - ip < 2) { hc_throw("Invalid compressed data"); }
+    const size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    size_t m = token & 15;
+    if (m == 15) { m += lz_get_length(&ip, ie); }
+    m += LZ_MIN_MATCH;
+
+    if (!offset || offset > op - out || m > oe - op) {
+      hc_throw("Invalid compressed data");
+    }
+
+    const uint8_t *ref = op - offset;
+
+    if (offset >= m) {
+      memcpy(op, ref, m);
+      op += m;
+    } else {
+      // Overlapping matches repeat the last offset bytes.
+      for (const uint8_t *e = op + m; op < e; *op++ = *ref++);
+    }
+  }
+
+  return op - out;
+}
+
+static void put32(uint8_t *p, const uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void hc_compress_stream_flush(struct hc_compress_stream *s) {
+  if (!s->length) {
+    return;
+  }
+
+  // Blocks that don't compress are stored as is, which is indicated
+  // by equal lengths.
+  uint8_t *p = s->buffer + LZ_HEADER_SIZE;
+  size_t n = hc_lz_compress(s->block, s->length, p);
+
+  if (n >= s->length) {
+    memcpy(p, s->block, s->length);
+    n = s->length;
+  }
+  
+  put32(s->buffer, s->length);
+  put32(s->buffer + 4, n);
+  hc_write(s->out, s->buffer, LZ_HEADER_SIZE + n);
+  s->length = 0;
+}
+
+static size_t compress_write(struct hc_stream *_s,
+			     const uint8_t *data,
+			     const size_t n) {
+  struct hc_compress_stream *s =
+    hc_baseof(_s, struct hc_compress_stream, stream);
+
+  for (size_t rest = n; rest;) {
+    const size_t m = hc_min(rest, s->opts.block_size - s->length);
+    memcpy(s->block + s->length, data, m);
+    s->length += m;
+    data += m;
+    rest -= m;
+    
+    if (s->length == s->opts.block_size) {
+      hc_compress_stream_flush(s);
+    }
+  }
+
+  return n;
+}
+
+static void compress_deinit(struct hc_stream *_s) {
+  struct hc_compress_stream *s =
+    hc_baseof(_s, struct hc_compress_stream, stream);
+
+  hc_compress_stream_flush(s);
+  free(s->block);
+  free(s->buffer);
+}
+
+struct hc_compress_stream *
+_hc_compress_stream_init(struct hc_compress_stream *s,
+			 struct hc_stream *out,
+			 const struct hc_compress_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .write  = compress_write,
+    .deinit = compress_deinit,
+  };
+
+  s->out = out;
+  s->opts = opts;
+  s->block = malloc(opts.block_size);
+  s->buffer = malloc(LZ_HEADER_SIZE + HC_LZ_BOUND(opts.block_size));
+  s->length = 0;
+  return s;
+}
+
+static bool read_header(struct hc_decompress_stream *s,
+			size_t *length,
+			size_t *n) {
+  uint8_t h[LZ_HEADER_SIZE];
+  const size_t hn = hc_read(s->in, h, LZ_HEADER_SIZE);
+
+  if (!hn) {
+    return false;
+  }
+
+  if (hn != LZ_HEADER_SIZE) {
+    hc_throw("Invalid compressed block header");
+  }
+
+  *length = get32(h);
+  *n = get32(h + 4);
+
+  if (*n > *length) {
+    hc_throw("Invalid compressed block header");
+  }
+  
+  return true;
+}
+
+static bool read_block(struct hc_decompress_stream *s) {
+  size_t length = 0, n = 0;
+
+  if (!read_header(s, &length, &n)) {
+    return false;
+  }
+
+  struct hc_vector *b = &s->block;
+  if (length > b->capacity) { hc_vector_grow(b, length); }
+  b->length = length;
+  b->end = b->start + length;
+  s->rpos = 0;
+
+  // Input is decompressed in place when the stream allows borrowing.
+  size_t an = 0;
+  const uint8_t *a = hc_acquire_read(s->in, &an);
+  const uint8_t *p = NULL;
+
+  if (a && an >= n) {
+    p = a;
+  } else {
+    struct hc_vector *bb = &s->buffer;
+    if (n > bb->capacity) { hc_vector_grow(bb, n); }
+
+    if (hc_read(s->in, bb->start, n) != n) {
+      hc_throw("Truncated compressed block");
+    }
+
+    p = bb->start;
+  }
+
+  if (n == length) {
+    memcpy(b->start, p, n);
+  } else if (hc_lz_decompress(p, n, b->start, length) != length) {
+    hc_throw("Invalid compressed block");
+  }
+
+  if (p == a) {
+    hc_release_read(s->in, n);
+  }
+  
+  return true;
+}
+
+static size_t decompress_read(struct hc_stream *_s,
+			      uint8_t *data,
+			      const size_t n) {
+  struct hc_decompress_stream *s =
+    hc_baseof(_s, struct hc_decompress_stream, stream);
+  
+  size_t result = 0;
+
+  while (result < n) {
+    if (s->rpos == s->block.length && !read_block(s)) {
+      break;
+    }
+    
+    const size_t m = hc_min(n - result, s->block.length - s->rpos);
+    memcpy(data + result, s->block.start + s->rpos, m);
+    s->rpos += m;
+    result += m;
+  }
+
+  return result;
+}
+
+static const uint8_t *decompress_acquire_read(struct hc_stream *_s,
+					      size_t *n) {
+  struct hc_decompress_stream *s =
+    hc_baseof(_s, struct hc_decompress_stream, stream);
+
+  if (s->rpos == s->block.length) {
+    read_block(s);
+  }
+  
+  *n = s->block.length - s->rpos;
+  return s->block.start + s->rpos;
+}
+
+static void decompress_release_read(struct hc_stream *_s, const size_t n) {
+  struct hc_decompress_stream *s =
+    hc_baseof(_s, struct hc_decompress_stream, stream);
+
+  assert(s->rpos + n <= s->block.length);
+  s->rpos += n;
+}
+
+static void decompress_deinit(struct hc_stream *_s) {
+  struct hc_decompress_stream *s =
+    hc_baseof(_s, struct hc_decompress_stream, stream);
+
+  hc_vector_deinit(&s->block);
+  hc_vector_deinit(&s->buffer);
+}
+
+struct hc_decompress_stream *
+hc_decompress_stream_init(struct hc_decompress_stream *s,
+			  struct hc_stream *in) {
+  s->stream = (struct hc_stream){
+    .read         = decompress_read,
+    .acquire_read = decompress_acquire_read,
+    .release_read = decompress_release_read,
+    .deinit       = decompress_deinit,
+  };
+
+  s->in = in;
+  hc_vector_init(&s->block, &hc_malloc_default, 1);
+  hc_vector_init(&s->buffer, &hc_malloc_default, 1);
+  s->rpos = 0;
+  return s;
+}
+
+size_t hc_decompress_stream_skip(struct hc_decompress_stream *s,
+				 const size_t n) {
+  // Whatever is left of the current block is dropped.
+  s->rpos = s->block.length;
+  size_t result = 0;
+  
+  for (; result < n; result++) {
+    size_t length = 0, bn = 0;
+
+    if (!read_header(s, &length, &bn)) {
+      break;
+    }
+
+    size_t an = 0;
+    
+    if (hc_acquire_read(s->in, &an) && an >= bn) {
+      hc_release_read(s->in, bn);
+      continue;
+    }
+    
+    struct hc_vector *b = &s->buffer;
+    if (bn > b->capacity) { hc_vector_grow(b, bn); }
+
+    if (hc_read(s->in, b->start, bn) != bn) {
+      hc_throw("Truncated compressed block");
+    }
+  }
+
+  return result;
+}
+
+/* Ring */
+
+static void ring_backoff(int *spins) {
+  if (*spins < 100) {
+    (*spins)++;
+  } else {
+    sched_yield();
+  }
+}
+
+static void ring_publish(struct hc_ring_stream *s) {
+  __atomic_store_n(&s->head, s->wpos, __ATOMIC_RELEASE);
+}
+
+static size_t ring_space(struct hc_ring_stream *s, const size_t n) {
+  const size_t capacity = s->mask + 1;
+  size_t result = capacity - (s->wpos - s->tail_cache);
+  
+  for (int spins = 0; result < n;) {
+    // The consumer can't see unpublished data, which would leave both
+    // sides waiting for each other.
+    if (s->head != s->wpos) { ring_publish(s); }
+    s->tail_cache = __atomic_load_n(&s->tail, __ATOMIC_ACQUIRE);
+    result = capacity - (s->wpos - s->tail_cache);
+    if (result < n) { ring_backoff(&spins); }
+  }
+
+  return result;
+}
+
+static void ring_commit(struct hc_ring_stream *s, const size_t n) {
+  s->wpos += n;
+
+  if (s->wpos - s->head >= s->opts.batch) {
+    ring_publish(s);
+  }
+}
+
+static size_t ring_available(struct hc_ring_stream *s) {
+  for (int spins = 0;; ring_backoff(&spins)) {
+    if (s->head_cache != s->tail) {
+      return s->head_cache - s->tail;
+    }
+
+    // Closed has to be checked before head, since the final publish
+    // happens before closing.
+    const bool closed = __atomic_load_n(&s->closed, __ATOMIC_ACQUIRE);
+    s->head_cache = __atomic_load_n(&s->head, __ATOMIC_ACQUIRE);
+    
+    if (s->head_cache != s->tail) {
+      return s->head_cache - s->tail;
+    }
+
+    if (closed) {
+      return 0;
+    }
+  }
+}
+
+static size_t ring_read(struct hc_stream *_s, uint8_t *data, const size_t n) {
+  struct hc_ring_stream *s = hc_baseof(_s, struct hc_ring_stream, stream);
+  const size_t capacity = s->mask + 1;
+  size_t result = 0;
+
+  while (result < n) {
+    const size_t available = ring_available(s);
+
+    if (!available) {
+      break;
+    }
+
+    const size_t m = hc_min(n - result, available);
+    const size_t i = s->tail & s->mask, m1 = hc_min(m, capacity - i);
+    memcpy(data + result, s->data + i, m1);
+    memcpy(data + result + m1, s->data, m - m1);
+    __atomic_store_n(&s->tail, s->tail + m, __ATOMIC_RELEASE);
+    result += m;
+  }
+
+  return result;
+}
+
+static size_t ring_write(struct hc_stream *_s,
+			 const uint8_t *data,
+			 const size_t n) {
+  struct hc_ring_stream *s = hc_baseof(_s, struct hc_ring_stream, stream);
+  const size_t capacity = s->mask + 1;
+  
+  for (size_t rest = n; rest;) {
+    const size_t m = hc_min(rest, ring_space(s, 1));
+    const size_t i = s->wpos & s->mask, m1 = hc_min(m, capacity - i);
+    memcpy(s->data + i, data, m1);
+    memcpy(s->data, data + m1, m - m1);
+    ring_commit(s, m);
+    data += m;
+    rest -= m;
+  }
+  
+  return n;
+}
+
+static const uint8_t *ring_acquire_read(struct hc_stream *_s, size_t *n) {
+  struct hc_ring_stream *s = hc_baseof(_s, struct hc_ring_stream, stream);
+  const size_t i = s->tail & s->mask;
+  *n = ring_available(s);
+
+  if (!s->opts.mirror) {
+    *n = hc_min(*n, s->mask + 1 - i);
+  }
+  
+  return s->data + i;
+}
+
+static void ring_release_read(struct hc_stream *_s, const size_t n) {
+  struct hc_ring_stream *s = hc_baseof(_s, struct hc_ring_stream, stream);
+  assert(n <= s->head_cache - s->tail);
+  __atomic_store_n(&s->tail, s->tail + n, __ATOMIC_RELEASE);
+}
+
+static uint8_t *ring_acquire_write(struct hc_stream *_s, const size_t n) {
+  struct hc_ring_stream *s = hc_baseof(_s, struct hc_ring_stream, stream);
+  const size_t i = s->wpos & s->mask;
+
+  if (n > s->mask + 1 || (!s->opts.mirror && i + n > s->mask + 1)) {
+    return NULL;
+  }
+
+  ring_space(s, n);
+  return s->data + i;
+}
+
+static void ring_commit_write(struct hc_stream *_s, const size_t n) {
+  ring_commit(hc_baseof(_s, struct hc_ring_stream, stream), n);
+}
+
+static void ring_deinit(struct hc_stream *_s) {
+  struct hc_ring_stream *s = hc_baseof(_s, struct hc_ring_stream, stream);
+
+  if (s->opts.mirror) {
+    munmap(s->data, 2 * (s->mask + 1));
+  } else {
+    free(s->data);
+  }
+}
+
+static uint8_t *ring_mirror(const size_t size) {
+  const int fd = memfd_create("hc_ring", 0);
+
+  if (fd == -1) {
+    return NULL;
+  }
+
+  hc_defer(close(fd));
+  
+  if (ftruncate(fd, size) == -1) {
+    return NULL;
+  }
+
+  uint8_t *p = mmap(NULL,
+		    2 * size,
+		    PROT_NONE,
+		    MAP_PRIVATE | MAP_ANONYMOUS,
+		    -1,
+		    0);
+  
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+
+  // Both halves map the same memory, which means that anything
+  // written past the end shows up at the start.
+  for (int i = 0; i < 2; i++) {
+    if (mmap(p + i * size,
+	     size,
+	     PROT_READ | PROT_WRITE,
+	     MAP_SHARED | MAP_FIXED,
+	     fd,
+	     0) == MAP_FAILED) {
+      munmap(p, 2 * size);
+      return NULL;
+    }
+  }
+
+  return p;
+}
+
+struct hc_ring_stream *_hc_ring_stream_init(struct hc_ring_stream *s,
+					    const struct hc_ring_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .read          = ring_read,
+    .write         = ring_write,
+    .acquire_read  = ring_acquire_read,
+    .release_read  = ring_release_read,
+    .acquire_write = ring_acquire_write,
+    .commit_write  = ring_commit_write,
+    .deinit        = ring_deinit,
+  };
+
+  s->opts = opts;
+  size_t capacity = 1;
+  
+  // Mirrored memory has to be a multiple of the page size.
+  if (opts.mirror) {
+    capacity = sysconf(_SC_PAGESIZE);
+  }
+  
+  while (capacity < opts.capacity) {
+    capacity *= 2;
+  }
+
+  s->data = opts.mirror ? ring_mirror(capacity) : NULL;
+
+  // Falling back to regular memory if mirroring fails, wrapping is
+  // still handled; just not as efficiently.
+  if (!s->data) {
+    s->opts.mirror = false;
+    s->data = malloc(capacity);
+  }
+  
+  s->mask = capacity - 1;
+  s->head = s->wpos = s->tail_cache = 0;
+  s->tail = s->head_cache = 0;
+  s->closed = false;
+  return s;
+}
+
+void hc_ring_stream_flush(struct hc_ring_stream *s) {
+  ring_publish(s);
+}
+
+void hc_ring_stream_close(struct hc_ring_stream *s) {
+  ring_publish(s);
+  __atomic_store_n(&s->closed, true, __ATOMIC_RELEASE);
+}
+
+/* Chunk */
+
+#define CHUNK_IOV_MAX 64
+
+struct hc_chunk {
+  struct hc_list chunks;
+  size_t size, length;
+  uint8_t data[];
+};
+
+static struct hc_chunk *chunk_new(struct hc_chunk_stream *s,
+				  const size_t size) {
+  struct hc_chunk *c = hc_acquire(s->malloc, sizeof(struct hc_chunk) + size);
+  c->size = size;
+  c->length = 0;
+  hc_list_push_back(&s->chunks, &c->chunks);
+  return c;
+}
+
+static void chunk_free(struct hc_chunk_stream *s, struct hc_chunk *c) {
+  hc_list_delete(&c->chunks);
+  hc_release(s->malloc, c);
+}
+
+static struct hc_chunk *chunk_front(struct hc_chunk_stream *s) {
+  // Consumed chunks are released as soon as there's a chunk following
+  // them, the last one is kept around for writing.
+  while (!hc_list_nil(&s->chunks)) {
+    struct hc_chunk *c = hc_baseof(s->chunks.next, struct hc_chunk, chunks);
+
+    if (s->rpos < c->length || c->chunks.next == &s->chunks) {
+      return c;
+    }
+
+    chunk_free(s, c);
+    s->rpos = 0;
+  }
+
+  return NULL;
+}
+
+static struct hc_chunk *chunk_back(struct hc_chunk_stream *s,
+				   const size_t n) {
+  struct hc_chunk *c = hc_list_nil(&s->chunks)
+    ? NULL
+    : hc_baseof(s->chunks.prev, struct hc_chunk, chunks);
+
+  if (!c || c->length + n > c->size) {
+    c = chunk_new(s, s->opts.chunk_size);
+  }
+
+  return c;
+}
+
+static void chunk_consume(struct hc_chunk_stream *s, const size_t n) {
+  struct hc_chunk *c = chunk_front(s);
+  assert(c && s->rpos + n <= c->length);
+  s->rpos += n;
+  s->length -= n;
+  chunk_front(s);
+}
+
+static size_t chunk_read(struct hc_stream *_s, uint8_t *data, const size_t n) {
+  struct hc_chunk_stream *s = hc_baseof(_s, struct hc_chunk_stream, stream);
+  size_t result = 0;
+
+  while (result < n && s->length) {
+    struct hc_chunk *c = chunk_front(s);
+    const size_t m = hc_min(n - result, c->length - s->rpos);
+    memcpy(data + result, c->data + s->rpos, m);
+    result += m;
+    chunk_consume(s, m);
+  }
+
+  return result;
+}
+
+static size_t chunk_write(struct hc_stream *_s,
+			  const uint8_t *data,
+			  const size_t n) {
+  struct hc_chunk_stream *s = hc_baseof(_s, struct hc_chunk_stream, stream);
+
+  for (size_t rest = n; rest;) {
+    struct hc_chunk *c = chunk_back(s, 1);
+    const size_t m = hc_min(rest, c->size - c->length);
+    memcpy(c->data + c->length, data, m);
+    c->length += m;
+    s->length += m;
+    data += m;
+    rest -= m;
+  }
+
+  return n;
+}
+
+static const uint8_t *chunk_acquire_read(struct hc_stream *_s, size_t *n) {
+  struct hc_chunk_stream *s = hc_baseof(_s, struct hc_chunk_stream, stream);
+  struct hc_chunk *c = chunk_front(s);
+
+  if (!c) {
+    *n = 0;
+    return NULL;
+  }
+  
+  *n = c->length - s->rpos;
+  return c->data + s->rpos;
+}
+
+static void chunk_release_read(struct hc_stream *_s, const size_t n) {
+  if (n) {
+    chunk_consume(hc_baseof(_s, struct hc_chunk_stream, stream), n);
+  }
+}
+
+static uint8_t *chunk_acquire_write(struct hc_stream *_s, const size_t n) {
+  struct hc_chunk_stream *s = hc_baseof(_s, struct hc_chunk_stream, stream);
+
+  if (n > s->opts.chunk_size) {
+    return NULL;
+  }
+
+  struct hc_chunk *c = chunk_back(s, n);
+  return c->data + c->length;
+}
+
+static void chunk_commit_write(struct hc_stream *_s, const size_t n) {
+  struct hc_chunk_stream *s = hc_baseof(_s, struct hc_chunk_stream, stream);
+  struct hc_chunk *c = hc_baseof(s->chunks.prev, struct hc_chunk, chunks);
+  assert(c->length + n <= c->size);
+  c->length += n;
+  s->length += n;
+}
+
+static void chunk_deinit(struct hc_stream *_s) {
+  struct hc_chunk_stream *s = hc_baseof(_s, struct hc_chunk_stream, stream);
+
+  hc_list_do(&s->chunks, c) {
+    chunk_free(s, hc_baseof(c, struct hc_chunk, chunks));
+  }
+}
+
+struct hc_chunk_stream *_hc_chunk_stream_init(struct hc_chunk_stream *s,
+					      struct hc_malloc *malloc,
+					      const struct hc_chunk_stream_opts opts) {
+  s->stream = (struct hc_stream){
+    .read          = chunk_read,
+    .write         = chunk_write,
+    .acquire_read  = chunk_acquire_read,
+    .release_read  = chunk_release_read,
+    .acquire_write = chunk_acquire_write,
+    .commit_write  = chunk_commit_write,
+    .deinit        = chunk_deinit,
+  };
+
+  s->malloc = malloc;
+  s->opts = opts;
+  hc_list_init(&s->chunks);
+  s->length = s->rpos = 0;
+  return s;
+}
+
+size_t hc_chunk_stream_flush(struct hc_chunk_stream *s,
+			     struct hc_stream *out) {
+  struct iovec iov[CHUNK_IOV_MAX];
+  size_t result = 0;
+  
+  while (s->length) {
+    chunk_front(s);
+    int n = 0;
+    size_t rpos = s->rpos;
+    
+    hc_list_do(&s->chunks, i) {
+      if (n == CHUNK_IOV_MAX) { break; }
+      struct hc_chunk *c = hc_baseof(i, struct hc_chunk, chunks);
+      iov[n++] = (struct iovec){c->data + rpos, c->length - rpos};
+      rpos = 0;
+    }
+
+    // Chunks are handed over to the other stream in one call, and
+    // released once written.
+    hc_writev(out, iov, n);
+
+    for (int i = 0; i < n; i++) {
+      result += iov[i].iov_len;
+      chunk_consume(s, iov[i].iov_len);
+    }
+  }
+
+  return result;
+}
+
+const char *hc_chunk_stream_string(struct hc_chunk_stream *s) {
+  struct hc_chunk *c = chunk_front(s);
+
+  // Data is only moved if it's spread over several chunks, or there's
+  // no room left for the terminator.
+  if (!c || c->length - s->rpos != s->length || c->length == c->size) {
+    const size_t n = s->length;
+    struct hc_chunk *lc = hc_acquire(s->malloc,
+				     sizeof(struct hc_chunk) + n + 1);
+    lc->size = n + 1;
+    lc->length = chunk_read(&s->stream, lc->data, n);
+
+    hc_list_do(&s->chunks, i) {
+      chunk_free(s, hc_baseof(i, struct hc_chunk, chunks));
+    }
+    
+    hc_list_push_back(&s->chunks, &lc->chunks);
+    s->length = n;
+    s->rpos = 0;
+    c = lc;
+  }
+
+  c->data[s->rpos + s->length] = 0;
+  return (const char *)c->data + s->rpos;
+}
+
+/* Lines */
+
+const uint8_t *hc_find_any(const uint8_t *data,
+			   const size_t n,
+			   const uint8_t *delimiters,
+			   const int delimiter_count) {
+  if (delimiter_count == 1) {
+    return memchr(data, delimiters[0], n);
+  }
+
+  const uint8_t *p = data, *const end = data + n;
+  
+#ifdef __SSE2__
+  __m128i ds[HC_LINE_DELIMITERS_MAX];
+
+  for (int i = 0; i < delimiter_count; i++) {
+    ds[i] = _mm_set1_epi8(delimiters[i]);
+  }
+  
+  // Sixteen bytes are compared to all delimiters at once, the position
+  // of the first match is given by the lowest bit set in the mask.
+  for (; end - p >= 16; p += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)p);
+    __m128i m = _mm_cmpeq_epi8(v, ds[0]);
+
+    for (int i = 1; i < delimiter_count; i++) {
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(v, ds[i]));
+    }
+
+    const int mask = _mm_movemask_epi8(m);
+    
+    if (mask) {
+      return p + __builtin_ctz(mask);
+    }
+  }
+#endif
+
+  for (; p < end; p++) {
+    for (int i = 0; i < delimiter_count; i++) {
+      if (*p == delimiters[i]) { return p; }
+    }
+  }
+
+  return NULL;
+}
+
+static const uint8_t *line_find(struct hc_line_reader *r,
+				const uint8_t *data,
+				const size_t n) {
+  return hc_find_any(data, n, r->delimiters, r->delimiter_count);
+}
+
+struct hc_line_reader *_hc_line_reader_init(struct hc_line_reader *r,
+					    struct hc_stream *in,
+					    const struct hc_line_reader_opts opts) {
+  const size_t dn = strlen(opts.delimiters);
+  
+  if (!dn || dn > HC_LINE_DELIMITERS_MAX) {
+    hc_throw("Invalid number of delimiters: %zu", dn);
+  }
+  
+  r->in = in;
+  r->opts = opts;
+  memcpy(r->delimiters, opts.delimiters, dn);
+  r->delimiter_count = dn;
+  hc_vector_init(&r->buffer, &hc_malloc_default, 1);
+  r->rpos = r->scanned = r->release = 0;
+  r->delimiter = 0;
+  return r;
+}
+
+void hc_line_reader_deinit(struct hc_line_reader *r) {
+  if (r->release) {
+    hc_release_read(r->in, r->release);
+    r->release = 0;
+  }
+  
+  hc_vector_deinit(&r->buffer);
+}
+
+static bool line_fill(struct hc_line_reader *r) {
+  struct hc_vector *b = &r->buffer;
+
+  if (r->in->acquire_read) {
+    size_t n = 0;
+    const uint8_t *p = hc_acquire_read(r->in, &n);
+
+    if (!n) {
+      return false;
+    }
+
+    // Only data up to and including the next delimiter is copied, the
+    // rest is left in the stream.
+    const uint8_t *d = line_find(r, p, n);
+    if (d) { n = d - p + 1; }
+    memcpy(hc_vector_insert(b, b->length, n), p, n);
+    hc_release_read(r->in, n);
+    return true;
+  }
+
+  const size_t size = r->opts.buffer_size;
+  uint8_t *p = hc_vector_insert(b, b->length, size);
+  const size_t n = hc_read(r->in, p, size);
+  hc_vector_delete(b, b->length - (size - n), size - n);
+  return n;
+}
+
+bool hc_line_reader_next(struct hc_line_reader *r,
+			 const uint8_t **line,
+			 size_t *n) {
+  struct hc_stream *in = r->in;
+  struct hc_vector *b = &r->buffer;
+  
+  if (r->release) {
+    hc_release_read(in, r->release);
+    r->release = 0;
+  }
+
+  // Lines are returned straight from the stream's memory when possible.
+  if (in->acquire_read && r->rpos == b->length) {
+    hc_vector_clear(b);
+    r->rpos = r->scanned = 0;
+    size_t an = 0;
+    const uint8_t *p = hc_acquire_read(in, &an);
+    const uint8_t *d = an ? line_find(r, p, an) : NULL;
+    
+    if (d) {
+      *line = p;
+      *n = d - p;
+      r->delimiter = *d;
+      r->release = *n + 1;
+      return true;
+    }
+  }
+
+  for (;;) {
+    const uint8_t *d = (r->scanned < b->length)
+      ? line_find(r, b->start + r->scanned, b->length - r->scanned)
+      : NULL;
+
+    if (d) {
+      *line = b->start + r->rpos;
+      *n = d - *line;
+      r->delimiter = *d;
+      r->rpos = r->scanned = d - b->start + 1;
+      return true;
+    }
+
+    r->scanned = b->length;
+
+    // Lines that have already been returned are dropped before
+    // reading more.
+    if (r->rpos) {
+      hc_vector_delete(b, 0, r->rpos);
+      r->scanned -= r->rpos;
+      r->rpos = 0;
+    }
+
+    if (!line_fill(r)) {
+      break;
+    }
+  }
+
+  if (r->rpos == b->length) {
+    return false;
+  }
+
+  // Whatever is left at the end is returned without delimiter.
+  *line = b->start + r->rpos;
+  *n = b->length - r->rpos;
+  r->delimiter = 0;
+  r->rpos = r->scanned = b->length;
+  return true;
+}
+
+/* Copy */
+
+enum copy_method {COPY_RANGE, COPY_SPLICE, COPY_SENDFILE, COPY_USER};
+
+static size_t copy_fds(const int out,
+		       const int in,
+		       const size_t n,
+		       enum copy_method *method) {
+  size_t result = 0;
+  
+  while (result < n && *method != COPY_USER) {
+    const size_t m = hc_min(n - result, (size_t)HC_COPY_MAX);
+    ssize_t r = -1;
+    
+    switch (*method) {
+    case COPY_RANGE:
+      r = copy_file_range(in, NULL, out, NULL, m, 0);
+      break;
+    case COPY_SPLICE:
+      r = splice(in, NULL, out, NULL, m, SPLICE_F_MOVE);
+      break;
+    case COPY_SENDFILE:
+      r = sendfile(out, in, NULL, m);
+      break;
+    case COPY_USER:
+      break;
+    }
+
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+
+      // Each method only works for some kinds of descriptors, which
+      // is signalled using a handful of different errors.
+      if (errno == EINVAL ||
+	  errno == EXDEV ||
+	  errno == ENOSYS ||
+	  errno == EOPNOTSUPP ||
+	  errno == EBADF) {
+	(*method)++;
+	continue;
+      }
+
+      hc_throw("Failed copying from fd %d to fd %d: %d", in, out, errno);
+    }
+
+    if (!r) {
+      break;
+    }
+    
+    result += r;
+  }
+
+  return result;
+}
+
+size_t hc_stream_copy(struct hc_stream *dst,
+		      struct hc_stream *src,
+		      const size_t n) {
+  const int in = hc_stream_fd(src), out = hc_stream_fd(dst);
+  enum copy_method method = (in == -1 || out == -1) ? COPY_USER : COPY_RANGE;
+  size_t result = copy_fds(out, in, n, &method);
+
+  if (method != COPY_USER) {
+    return result;
+  }
+
+  uint8_t *buffer = NULL;
+  hc_defer(free(buffer));
+  
+  while (result < n) {
+    const size_t rest = n - result;
+    
+    // Borrowed memory on either side saves a copy.
+    if (src->acquire_read) {
+      size_t m = 0;
+      const uint8_t *p = hc_acquire_read(src, &m);
+      if (!m) { break; }
+      m = hc_min(m, rest);
+      hc_write(dst, p, m);
+      hc_release_read(src, m);
+      result += m;
+      continue;
+    }
+
+    size_t m = hc_min(rest, (size_t)HC_COPY_BUFFER_SIZE);
+    uint8_t *p = hc_acquire_write(dst, m);
+
+    if (p) {
+      m = hc_read(src, p, m);
+      hc_commit_write(dst, m);
+    } else {
+      if (!buffer) { buffer = malloc(HC_COPY_BUFFER_SIZE); }
+      m = hc_write(dst, buffer, hc_read(src, buffer, m));
+    }
+    
+    if (!m) {
+      break;
+    }
+    
+    result += m;
+  }
+
+  return result;
+}
@@ -0,0 +1,290 @@
+#ifndef HACKTICAL_STREAM2_H
+#define HACKTICAL_STREAM2_H
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "list/list.h"
+#include "stream1/stream1.h"
+
+/* FD */
+
+#define HC_FD_ALIGN 4096
+#define HC_FD_BUFFER_SIZE (64 * 1024)
+
+struct hc_fd_stream_opts {
+  size_t buffer_size;
+  bool close_fd;
+  bool direct;
+};
+
+struct hc_fd_stream {
+  struct hc_stream stream;
+  int fd;
+  struct hc_fd_stream_opts opts;
+  uint8_t *buffer;
+  size_t length, rpos, rlength;
+  off_t offset;
+};
+
+#define hc_fd_stream_init(s, fd, ...)				\
+  _hc_fd_stream_init(s, fd, (struct hc_fd_stream_opts){		\
+      .buffer_size = HC_FD_BUFFER_SIZE,				\
+      .close_fd = false,					\
+      .direct = false,						\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_fd_stream *_hc_fd_stream_init(struct hc_fd_stream *s,
+					int fd,
+					struct hc_fd_stream_opts opts);
+
+void hc_fd_stream_flush(struct hc_fd_stream *s);
+
+size_t hc_fd_stream_pread(struct hc_fd_stream *s,
+			  uint8_t *data,
+			  size_t n,
+			  off_t offset);
+
+size_t hc_fd_stream_pwrite(struct hc_fd_stream *s,
+			   const uint8_t *data,
+			   size_t n,
+			   off_t offset);
+
+/* MMap */
+
+struct hc_mmap_stream_opts {
+  bool sequential;
+  bool willneed;
+};
+
+struct hc_mmap_stream {
+  struct hc_stream stream;
+  uint8_t *data;
+  size_t length, size, rpos;
+};
+
+#define hc_mmap_stream_init(s, fd, ...)				\
+  _hc_mmap_stream_init(s, fd, (struct hc_mmap_stream_opts){	\
+      .sequential = true,					\
+      .willneed = false,					\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_mmap_stream *_hc_mmap_stream_init(struct hc_mmap_stream *s,
+					    int fd,
+					    struct hc_mmap_stream_opts opts);
+
+/* URing */
+
+struct hc_uring;
+struct hc_uring_pool;
+struct hc_uring_slot;
+
+struct hc_uring_stream_opts {
+  size_t buffer_size, buffer_count, batch, threads;
+  bool close_fd;
+  bool force_threads;
+};
+
+struct hc_uring_stream {
+  struct hc_stream stream;
+  int fd;
+  struct hc_uring_stream_opts opts;
+  struct hc_uring *uring;
+  struct hc_uring_pool *pool;
+  struct hc_uring_slot *slots;
+  size_t next, queued;
+  off_t offset;
+  bool reading;
+};
+
+#define hc_uring_stream_init(s, fd, ...)				\
+  _hc_uring_stream_init(s, fd, (struct hc_uring_stream_opts){		\
+      .buffer_size = HC_FD_BUFFER_SIZE,					\
+      .buffer_count = 8,						\
+      .batch = 4,							\
+      .threads = 2,							\
+      .close_fd = false,						\
+      .force_threads = false,						\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_uring_stream *_hc_uring_stream_init(struct hc_uring_stream *s,
+					      int fd,
+					      struct hc_uring_stream_opts opts);
+
+void hc_uring_stream_submit(struct hc_uring_stream *s);
+bool hc_uring_stream_busy(struct hc_uring_stream *s);
+void hc_uring_stream_flush(struct hc_uring_stream *s);
+
+/* Compress */
+
+#define HC_COMPRESS_BLOCK_SIZE (64 * 1024)
+#define HC_LZ_BOUND(n) ((n) + (n) / 255 + 16)
+
+size_t hc_lz_compress(const uint8_t *in, size_t n, uint8_t *out);
+
+size_t hc_lz_decompress(const uint8_t *in,
+			size_t n,
+			uint8_t *out,
+			size_t out_n);
+
+struct hc_compress_stream_opts {
+  size_t block_size;
+};
+
+struct hc_compress_stream {
+  struct hc_stream stream;
+  struct hc_stream *out;
+  struct hc_compress_stream_opts opts;
+  uint8_t *block, *buffer;
+  size_t length;
+};
+
+#define hc_compress_stream_init(s, out, ...)				\
+  _hc_compress_stream_init(s, out, (struct hc_compress_stream_opts){	\
+      .block_size = HC_COMPRESS_BLOCK_SIZE,				\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_compress_stream *
+_hc_compress_stream_init(struct hc_compress_stream *s,
+			 struct hc_stream *out,
+			 struct hc_compress_stream_opts opts);
+
+void hc_compress_stream_flush(struct hc_compress_stream *s);
+
+struct hc_decompress_stream {
+  struct hc_stream stream;
+  struct hc_stream *in;
+  struct hc_vector block, buffer;
+  size_t rpos;
+};
+
+struct hc_decompress_stream *
+hc_decompress_stream_init(struct hc_decompress_stream *s,
+			  struct hc_stream *in);
+
+size_t hc_decompress_stream_skip(struct hc_decompress_stream *s, size_t n);
+
+/* Ring */
+
+#define HC_CACHE_LINE 64
+
+struct hc_ring_stream_opts {
+  size_t capacity, batch;
+  bool mirror;
+};
+
+struct hc_ring_stream {
+  struct hc_stream stream;
+  struct hc_ring_stream_opts opts;
+  uint8_t *data;
+  size_t mask;
+
+  // Only touched by the producer, except for head.
+  alignas(HC_CACHE_LINE) size_t head;
+  size_t wpos, tail_cache;
+  bool closed;
+
+  // Only touched by the consumer, except for tail.
+  alignas(HC_CACHE_LINE) size_t tail;
+  size_t head_cache;
+};
+
+#define hc_ring_stream_init(s, ...)					\
+  _hc_ring_stream_init(s, (struct hc_ring_stream_opts){			\
+      .capacity = HC_FD_BUFFER_SIZE,					\
+      .batch = 0,							\
+      .mirror = false,							\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_ring_stream *_hc_ring_stream_init(struct hc_ring_stream *s,
+					    struct hc_ring_stream_opts opts);
+
+void hc_ring_stream_flush(struct hc_ring_stream *s);
+void hc_ring_stream_close(struct hc_ring_stream *s);
+
+/* Chunk */
+
+#define HC_CHUNK_SIZE (16 * 1024)
+
+struct hc_chunk_stream_opts {
+  size_t chunk_size;
+};
+
+struct hc_chunk_stream {
+  struct hc_stream stream;
+  struct hc_malloc *malloc;
+  struct hc_chunk_stream_opts opts;
+  struct hc_list chunks;
+  size_t length, rpos;
+};
+
+#define hc_chunk_stream_init(s, m, ...)					\
+  _hc_chunk_stream_init(s, m, (struct hc_chunk_stream_opts){		\
+      .chunk_size = HC_CHUNK_SIZE,					\
+      ##__VA_ARGS__							\
+    })
+
+struct hc_chunk_stream *_hc_chunk_stream_init(struct hc_chunk_stream *s,
+					      struct hc_malloc *malloc,
+					      struct hc_chunk_stream_opts opts);
+
+size_t hc_chunk_stream_flush(struct hc_chunk_stream *s, struct hc_stream *out);
+const char *hc_chunk_stream_string(struct hc_chunk_stream *s);
+
+/* Lines */
+
+#define HC_LINE_DELIMITERS_MAX 8
+
+struct hc_line_reader_opts {
+  const char *delimiters;
+  size_t buffer_size;
+};
+
+struct hc_line_reader {
+  struct hc_stream *in;
+  struct hc_line_reader_opts opts;
+  uint8_t delimiters[HC_LINE_DELIMITERS_MAX];
+  int delimiter_count;
+  struct hc_vector buffer;
+  size_t rpos, scanned, release;
+  char delimiter;
+};
+
+#define hc_line_reader_init(r, in, ...)				\
+  _hc_line_reader_init(r, in, (struct hc_line_reader_opts){	\
+      .delimiters = "\n",					\
+      .buffer_size = HC_FD_BUFFER_SIZE,				\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_line_reader *_hc_line_reader_init(struct hc_line_reader *r,
+					    struct hc_stream *in,
+					    struct hc_line_reader_opts opts);
+
+void hc_line_reader_deinit(struct hc_line_reader *r);
+
+bool hc_line_reader_next(struct hc_line_reader *r,
+			 const uint8_t **line,
+			 size_t *n);
+
+const uint8_t *hc_find_any(const uint8_t *data,
+			   size_t n,
+			   const uint8_t *delimiters,
+			   int delimiter_count);
+
+/* Copy */
+
+#define HC_COPY_BUFFER_SIZE HC_FD_BUFFER_SIZE
+#define HC_COPY_MAX (1 << 30)
+
+size_t hc_stream_copy(struct hc_stream *dst, struct hc_stream *src, size_t n);
+
+#endif
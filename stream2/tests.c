@@ -0,0 +1,430 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stream2.h"
+#include "task/task.h"
+
+static void fd_tests(const bool direct) {
+  char path[] = "/tmp/hc_fd_XXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd != -1);
+  hc_defer(unlink(path));
+  struct hc_fd_stream s;
+  bool ok = false;
+
+  // Not every file system supports direct I/O
+  void on_catch(struct hc_error *e) {
+    close(fd);
+  }
+  
+  hc_catch(on_catch) {
+    hc_fd_stream_init(&s, fd,
+		      .buffer_size = HC_FD_ALIGN,
+		      .close_fd = true,
+		      .direct = direct);
+    ok = true;
+  }
+
+  if (!ok) {
+    return;
+  }
+  
+  hc_defer(hc_stream_deinit(&s.stream));
+  hc_puts(&s.stream, "foo");
+  const size_t n = HC_FD_ALIGN * 2 + 1;
+  uint8_t data[n];
+  memset(data, 'x', n);
+  hc_write(&s.stream, data, n);
+  uint8_t *dst = hc_acquire_write(&s.stream, 3);
+  memset(dst, 'x', 3);
+  hc_commit_write(&s.stream, 3);
+  hc_fd_stream_flush(&s);
+  assert(lseek(fd, 0, SEEK_END) == n + 6);
+
+  // More buffers than writev() accepts in one call.
+  const int m = 2000;
+  struct iovec iov[m];
+  for (int i = 0; i < m; i++) { iov[i] = (struct iovec){data, 4}; }
+  hc_puts(&s.stream, "foo");
+  assert(hc_writev(&s.stream, iov, m) == m * 4);
+  hc_fd_stream_flush(&s);
+  assert(lseek(fd, 0, SEEK_END) == n + 9 + m * 4);
+  
+  if (direct) {
+    return;
+  }
+  
+  char buf[4] = {0};
+  assert(hc_fd_stream_pread(&s, (uint8_t *)buf, 3, 0) == 3);
+  assert(strcmp(buf, "foo") == 0);
+  hc_fd_stream_pwrite(&s, (const uint8_t *)"bar", 3, 0);
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  assert(hc_read(&s.stream, (uint8_t *)buf, 3) == 3);
+  assert(strcmp(buf, "bar") == 0);
+}
+
+static void mmap_tests() {
+  char path[] = "/tmp/hc_mmap_XXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd != -1);
+  hc_defer(unlink(path));
+  hc_defer(close(fd));
+  assert(write(fd, "foo bar", 7) == 7);
+  
+  struct hc_mmap_stream s;
+  hc_mmap_stream_init(&s, fd, .willneed = true);
+  hc_defer(hc_stream_deinit(&s.stream));
+  char buf[4] = {0};
+  assert(hc_read(&s.stream, (uint8_t *)buf, 3) == 3);
+  assert(strcmp(buf, "foo") == 0);
+  
+  const uint8_t *data = NULL;
+  size_t n = 0;
+  assert(hc_stream_view(&s.stream, &data, &n));
+  assert(n == 4);
+  assert(strcmp((const char *)data, " bar") == 0);
+  hc_release_read(&s.stream, 1);
+  assert(hc_acquire_read(&s.stream, &n) == data + 1 && n == 3);
+}
+
+struct uring_task {
+  struct hc_task task;
+  struct hc_uring_stream *stream;
+  int fd;
+};
+
+static void uring_writer(struct hc_task *task) {
+  struct uring_task *t = hc_baseof(task, struct uring_task, task);
+  struct hc_uring_stream *s = t->stream;
+  
+  switch (task->state) {
+  case 0:
+    for (int i = 0; i < 100; i++) {
+      hc_puts(&s->stream, "0123456789");
+    }
+
+    hc_uring_stream_submit(s);
+    
+    while (hc_uring_stream_busy(s)) {
+      hc_task_yield(task);
+    }
+
+    // Includes the partly filled last buffer.
+    struct stat st;
+    assert(fstat(t->fd, &st) == 0 && st.st_size == 1000);
+  }
+
+  task->done = true;
+}
+
+static void uring_tests(const bool force_threads) {
+  char path[] = "/tmp/hc_uring_XXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd != -1);
+  hc_defer(unlink(path));
+  hc_defer(close(fd));
+
+  {
+    struct hc_uring_stream s;
+    
+    hc_uring_stream_init(&s, fd,
+			 .buffer_size = 64,
+			 .buffer_count = 4,
+			 .batch = 2,
+			 .force_threads = force_threads);
+    
+    hc_defer(hc_stream_deinit(&s.stream));
+    struct hc_task_list tl;
+    hc_task_list_init(&tl);
+    struct uring_task t = {.stream = &s, .fd = fd};
+    hc_task_init(&t.task, &tl, &uring_writer);
+    hc_task_list_run(&tl);
+  }
+
+  assert(lseek(fd, 0, SEEK_END) == 1000);
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  struct hc_uring_stream s;
+  hc_uring_stream_init(&s, fd, .buffer_size = 64, .buffer_count = 4);
+  hc_defer(hc_stream_deinit(&s.stream));
+  char buf[1001] = {0};
+  assert(hc_read(&s.stream, (uint8_t *)buf, 1001) == 1000);
+  assert(strncmp(buf + 990, "0123456789", 10) == 0);
+}
+
+static void compress_tests() {
+  const size_t n = 10000;
+  uint8_t data[n];
+
+  // Repeating text followed by noise, to cover both kinds of blocks
+  for (size_t i = 0; i < n / 2; i++) { data[i] = "0123456789"[i % 10]; }
+  srand(42);
+  for (size_t i = n / 2; i < n; i++) { data[i] = rand(); }
+  
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&out.stream));
+
+  {
+    struct hc_compress_stream s;
+    hc_compress_stream_init(&s, &out.stream, .block_size = 1000);
+    hc_defer(hc_stream_deinit(&s.stream));
+    hc_write(&s.stream, data, n);
+  }
+
+  assert(out.data.length < n);
+
+  {
+    struct hc_decompress_stream s;
+    hc_decompress_stream_init(&s, &out.stream);
+    hc_defer(hc_stream_deinit(&s.stream));
+    uint8_t result[n + 1];
+    assert(hc_read(&s.stream, result, n + 1) == n);
+    assert(memcmp(data, result, n) == 0);
+  }
+
+  out.rpos = 0;
+  struct hc_decompress_stream s;
+  hc_decompress_stream_init(&s, &out.stream);
+  hc_defer(hc_stream_deinit(&s.stream));
+  assert(hc_getc(&s.stream) == '0');
+  assert(hc_decompress_stream_skip(&s, 7) == 7);
+  uint8_t result[n];
+  assert(hc_read(&s.stream, result, n) == 2000);
+  assert(memcmp(data + 8000, result, 2000) == 0);
+}
+
+static void *ring_producer(void *arg) {
+  struct hc_ring_stream *s = arg;
+
+  for (uint32_t i = 0; i < 100000; i++) {
+    hc_write(&s->stream, (const uint8_t *)&i, sizeof(i));
+  }
+
+  hc_printf(&s->stream, "%s", "done");
+  hc_ring_stream_close(s);
+  return NULL;
+}
+
+static void ring_tests(const bool mirror) {
+  struct hc_ring_stream s;
+  hc_ring_stream_init(&s, .capacity = 4096, .batch = 64, .mirror = mirror);
+  hc_defer(hc_stream_deinit(&s.stream));
+  pthread_t producer;
+  assert(pthread_create(&producer, NULL, ring_producer, &s) == 0);
+
+  for (uint32_t i = 0; i < 100000;) {
+    size_t n = 0;
+    const uint8_t *p = hc_acquire_read(&s.stream, &n);
+    assert(n);
+
+    if (n < sizeof(i)) {
+      // Values may be split across the end when not mirrored
+      assert(!s.opts.mirror);
+      uint32_t v = 0;
+      assert(hc_read(&s.stream, (uint8_t *)&v, sizeof(v)) == sizeof(v));
+      assert(v == i++);
+      continue;
+    }
+    
+    n = hc_min(n - n % sizeof(i), (100000 - i) * sizeof(i));
+
+    for (const uint8_t *e = p + n; p < e; p += sizeof(i), i++) {
+      uint32_t v;
+      memcpy(&v, p, sizeof(v));
+      assert(v == i);
+    }
+
+    hc_release_read(&s.stream, n);
+  }
+
+  char done[5] = {0};
+  assert(hc_read(&s.stream, (uint8_t *)done, sizeof(done)) == 4);
+  assert(strcmp(done, "done") == 0);
+  pthread_join(producer, NULL);
+}
+
+static void chunk_tests() {
+  struct hc_chunk_stream s;
+  hc_chunk_stream_init(&s, &hc_malloc_default, .chunk_size = 64);
+  hc_defer(hc_stream_deinit(&s.stream));
+  struct hc_memory_stream expected;
+  hc_memory_stream_init(&expected, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&expected.stream));
+
+  for (int i = 0; i < 100; i++) {
+    hc_printf(&s.stream, "%d ", i);
+    hc_printf(&expected.stream, "%d ", i);
+  }
+
+  hc_puts(&s.stream, "0123456789012345678901234567890123456789");
+  hc_puts(&expected.stream, "0123456789012345678901234567890123456789");
+  assert(hc_getc(&s.stream) == '0');
+  assert(hc_getc(&expected.stream) == '0');
+  char buf[100];
+  assert(hc_read(&s.stream, (uint8_t *)buf, 100) == 100);
+  assert(strncmp(buf, hc_memory_stream_string(&expected) + 1, 100) == 0);
+  expected.rpos += 100;
+  
+  assert(strcmp(hc_chunk_stream_string(&s),
+		hc_memory_stream_string(&expected) + expected.rpos) == 0);
+
+  hc_putc(&s.stream, '!');
+  char path[] = "/tmp/hc_chunk_XXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd != -1);
+  hc_defer(unlink(path));
+  hc_defer(close(fd));
+  const size_t n = s.length;
+  
+  {
+    struct hc_fd_stream out;
+    hc_fd_stream_init(&out, fd, .buffer_size = 16);
+    hc_defer(hc_stream_deinit(&out.stream));
+    assert(hc_chunk_stream_flush(&s, &out.stream) == n);
+    assert(!s.length);
+  }
+
+  struct hc_mmap_stream in;
+  hc_mmap_stream_init(&in, fd);
+  hc_defer(hc_stream_deinit(&in.stream));
+  assert(in.length == n);
+  assert(strncmp((const char *)in.data,
+		 hc_memory_stream_string(&expected) + expected.rpos,
+		 n - 1) == 0);
+  assert(in.data[n - 1] == '!');
+}
+
+static void lines_test(struct hc_stream *in, const char *delimiters) {
+  struct hc_line_reader r;
+  hc_line_reader_init(&r, in, .delimiters = delimiters, .buffer_size = 4);
+  hc_defer(hc_line_reader_deinit(&r));
+  const char *expected[] = {"foo", "", "0123456789abcdefghij", "bar"};
+  const uint8_t *line = NULL;
+  size_t n = 0;
+  
+  for (int i = 0; i < 4; i++) {
+    assert(hc_line_reader_next(&r, &line, &n));
+    assert(n == strlen(expected[i]));
+    assert(strncmp((const char *)line, expected[i], n) == 0);
+  }
+
+  assert(!r.delimiter);
+  assert(!hc_line_reader_next(&r, &line, &n));
+}
+
+static void lines_tests() {
+  const char *data = "foo\n\n0123456789abcdefghij\nbar";
+
+  {
+    struct hc_memory_stream s;
+    hc_memory_stream_init(&s, &hc_malloc_default);
+    hc_defer(hc_stream_deinit(&s.stream));
+    hc_puts(&s.stream, data);
+    lines_test(&s.stream, "\n");
+  }
+
+  {
+    struct hc_chunk_stream s;
+    hc_chunk_stream_init(&s, &hc_malloc_default, .chunk_size = 8);
+    hc_defer(hc_stream_deinit(&s.stream));
+    hc_puts(&s.stream, "foo;,0123456789abcdefghij\nbar");
+    lines_test(&s.stream, ",;\n");
+  }
+
+  char path[] = "/tmp/hc_lines_XXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd != -1);
+  hc_defer(unlink(path));
+  assert(write(fd, data, strlen(data)) == strlen(data));
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  struct hc_fd_stream s;
+  hc_fd_stream_init(&s, fd, .close_fd = true);
+  hc_defer(hc_stream_deinit(&s.stream));
+  lines_test(&s.stream, "\n");
+
+  const uint8_t ds[] = {'x', 'y', 'z'};
+  const char *text = "0123456789abcdefghijklmnopqrstuvwxyz";
+  assert(hc_find_any((const uint8_t *)text, strlen(text), ds, 3) ==
+	 (const uint8_t *)text + 33);
+}
+
+static void copy_tests() {
+  char path[] = "/tmp/hc_copy_XXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd != -1);
+  hc_defer(unlink(path));
+  hc_defer(close(fd));
+  struct hc_memory_stream data;
+  hc_memory_stream_init(&data, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&data.stream));
+  for (int i = 0; i < 1000; i++) { hc_printf(&data.stream, "%d ", i); }
+  const char *expected = hc_memory_stream_string(&data);
+  const size_t n = strlen(expected);
+
+  // Memory to file in user space
+  {
+    struct hc_fd_stream out;
+    hc_fd_stream_init(&out, fd);
+    hc_defer(hc_stream_deinit(&out.stream));
+    assert(hc_stream_copy(&out.stream, &data.stream, n) == n);
+  }
+
+  // File to file and pipe in kernel space
+  char copy_path[] = "/tmp/hc_copy_XXXXXX";
+  const int copy_fd = mkstemp(copy_path);
+  assert(copy_fd != -1);
+  hc_defer(unlink(copy_path));
+  int p[2];
+  assert(pipe(p) == 0);
+  hc_defer(close(p[0]));
+  
+  {
+    assert(lseek(fd, 0, SEEK_SET) == 0);
+    struct hc_fd_stream in;
+    hc_fd_stream_init(&in, fd);
+    hc_defer(hc_stream_deinit(&in.stream));
+
+    struct hc_file_stream out;
+    hc_file_stream_init(&out, fdopen(copy_fd, "w+"), .close_file = true);
+    hc_defer(hc_stream_deinit(&out.stream));
+    hc_puts(&out.stream, "foo ");
+    assert(hc_stream_copy(&out.stream, &in.stream, 10) == 10);
+    assert(hc_stream_copy(&out.stream, &in.stream, SIZE_MAX) == n - 10);
+
+    struct hc_fd_stream pipe_out;
+    hc_fd_stream_init(&pipe_out, p[1], .close_fd = true);
+    hc_defer(hc_stream_deinit(&pipe_out.stream));
+    rewind(out.file);
+    assert(hc_stream_copy(&pipe_out.stream, &out.stream, SIZE_MAX) == n + 4);
+  }
+
+  // Pipe to memory in user space
+  struct hc_fd_stream in;
+  hc_fd_stream_init(&in, p[0]);
+  hc_defer(hc_stream_deinit(&in.stream));
+  struct hc_memory_stream out;
+  hc_memory_stream_init(&out, &hc_malloc_default);
+  hc_defer(hc_stream_deinit(&out.stream));
+  assert(hc_stream_copy(&out.stream, &in.stream, SIZE_MAX) == n + 4);
+  const char *result = hc_memory_stream_string(&out);
+  assert(strncmp(result, "foo ", 4) == 0);
+  assert(strcmp(result + 4, expected) == 0);
+}
+
+void stream2_tests() {
+  fd_tests(false);
+  fd_tests(true);
+  mmap_tests();
+  uring_tests(false);
+  uring_tests(true);
+  compress_tests();
+  ring_tests(false);
+  ring_tests(true);
+  chunk_tests();
+  lines_tests();
+  copy_tests();
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "chrono/chrono.h"
+#include "task.h"
+
+#define TASK_IDLE 100000
+#define TASK_ACTIVE 10
+#define TASK_STEPS 100000
+
+struct bench_task {
+  struct hc_task task;
+  int steps;
+};
+
+static void bench_idle(struct hc_task *task) {
+  switch (task->state) {
+  case 0:
+    hc_task_wait(task);
+  }
+
+  task->done = true;
+}
+
+static void bench_active(struct hc_task *task) {
+  struct bench_task *t = hc_baseof(task, struct bench_task, task);
+
+  switch (task->state) {
+  case 0:
+    while (t->steps--) {
+      hc_task_yield(task);
+    }
+  }
+
+  task->done = true;
+}
+
+static void bench_executor(const int workers) {
+  struct hc_executor e;
+  hc_executor_init(&e, .workers = workers);
+  const int n = TASK_STEPS / 10;
+  struct bench_task *ts = malloc(n * sizeof(struct bench_task));
+  hc_time_t t = hc_now();
+  
+  for (int i = 0; i < n; i++) {
+    ts[i].steps = 10;
+    hc_executor_spawn(&e, &ts[i].task, &bench_active);
+  }
+
+  hc_executor_wait(&e);
+  
+  printf("executor %d workers: %.1fns/step\n",
+	 e.opts.workers, (double)hc_time_ns(&t) / TASK_STEPS);
+
+  hc_executor_deinit(&e);
+  free(ts);
+}
+
+void task_benchmarks() {
+  struct hc_task_list tl;
+  hc_task_list_init(&tl);
+  struct bench_task *idle = malloc(TASK_IDLE * sizeof(struct bench_task));
+  struct bench_task active[TASK_ACTIVE];
+
+  for (int i = 0; i < TASK_IDLE; i++) {
+    hc_task_init(&idle[i].task, &tl, &bench_idle);
+  }
+
+  // Parks the idle tasks.
+  hc_task_list_run(&tl);
+  
+  for (int i = 0; i < TASK_ACTIVE; i++) {
+    active[i].steps = TASK_STEPS / TASK_ACTIVE;
+    hc_task_init(&active[i].task, &tl, &bench_active);
+  }
+
+  hc_time_t t = hc_now();
+  hc_task_list_run(&tl);
+  
+  printf("task %d active/%d idle: %.1fns/step\n",
+	 TASK_ACTIVE, TASK_IDLE, (double)hc_time_ns(&t) / TASK_STEPS);
+
+  for (int i = 0; i < TASK_IDLE; i++) {
+    hc_task_wake(&idle[i].task);
+  }
+
+  hc_task_list_run(&tl);
+  free(idle);
+
+  bench_executor(1);
+  bench_executor(0);
+}
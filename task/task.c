@@ -1,35 +1,389 @@
-#include <stddef.h>
-#include <stdlib.h>
-#include "task.h"
-
-struct hc_task *hc_task_init(struct hc_task *t,
-			     struct hc_task_list *tl,
-			     hc_task_body body) {
-  t->body = body;
-  t->state = 0;
-  t->done = false;
-  hc_list_push_back(&tl->tasks, &t->list);
-  return t;
-}
-
-struct hc_task_list *hc_task_list_init(struct hc_task_list *tl) {
-  hc_list_init(&tl->tasks);
-  return tl;
-}
-
-void hc_task_list_run(const struct hc_task_list *tl) {
-  bool all_done = false;
-  
-  while (!all_done) {
-    all_done = true;
-    
-    hc_list_do(&tl->tasks, i) {
-      struct hc_task *t = hc_baseof(i, struct hc_task, list);
-
-      if (!t->done) {
-	t->body(t);
-	all_done = false;
-      }
-    }
-  }
-}
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "error/error.h"
+#include "task.h"
+
+static void task_timeout(struct hc_timer *timer) {
+  hc_task_wake(hc_baseof(timer, struct hc_task, timer));
+}
+
+struct hc_task *hc_task_init(struct hc_task *t,
+			     struct hc_task_list *tl,
+			     hc_task_body body) {
+  t->owner = tl;
+  t->body = body;
+  t->state = 0;
+  t->done = t->parked = false;
+  hc_timer_init(&t->timer, task_timeout);
+  hc_list_push_back(&tl->ready, &t->list);
+  return t;
+}
+
+struct hc_task_list *hc_task_list_init(struct hc_task_list *tl) {
+  hc_list_init(&tl->ready);
+  hc_list_init(&tl->parked);
+  hc_timer_wheel_init(&tl->timers);
+  return tl;
+}
+
+void hc_task_park(struct hc_task *t) {
+  // Executors don't support parking.
+  assert(t->owner);
+  
+  if (!t->parked) {
+    t->parked = true;
+    hc_list_delete(&t->list);
+    hc_list_push_back(&t->owner->parked, &t->list);
+  }
+}
+
+void hc_task_park_for(struct hc_task *t, const uint64_t ns) {
+  hc_task_park(t);
+  hc_timer_start(&t->owner->timers, &t->timer, hc_ns() + ns);
+}
+
+void hc_task_wake(struct hc_task *t) {
+  if (t->parked) {
+    t->parked = false;
+    hc_timer_cancel(&t->owner->timers, &t->timer);
+    hc_list_delete(&t->list);
+    hc_list_push_back(&t->owner->ready, &t->list);
+  }
+}
+
+static void task_run(struct hc_task_list *tl, struct hc_task *t) {
+  t->body(t);
+
+  if (t->done) {
+    hc_task_wake(t);
+    hc_list_delete(&t->list);
+    hc_list_init(&t->list);
+  } else if (hc_list_nil(&t->list)) {
+    hc_list_push_back(&tl->ready, &t->list);
+  }
+}
+
+void hc_task_list_run(struct hc_task_list *tl) {
+  for (;;) {
+    // Tasks that are made ready while running end up at the back and
+    // wait for the next pass. Tasks may be parked by others while
+    // waiting, which is why the pass is counted rather than marked.
+    size_t n = 0;
+    hc_list_do(&tl->ready, i) { n++; }
+
+    for (struct hc_list *i; n-- && (i = hc_list_pop_front(&tl->ready));) {
+      hc_list_init(i);
+      task_run(tl, hc_baseof(i, struct hc_task, list));
+    }
+    
+    const bool idle = hc_list_nil(&tl->ready);
+    
+    // Tasks that are parked without a timer are left for whoever wakes
+    // them up.
+    if (!tl->timers.count) {
+      if (idle) { break; }
+      continue;
+    }
+
+    // Sleeps until the next timer if there's nothing else to do.
+    if (idle) {
+      const hc_ns_t now = hc_ns(), next = hc_timer_wheel_next(&tl->timers);
+      if (next > now) { hc_sleep(next - now); }
+    }
+    
+    hc_timer_wheel_advance(&tl->timers, hc_ns());
+  }
+}
+
+/* Executor */
+
+#define EXECUTOR_BATCH 32
+#define EXECUTOR_INJECT_INTERVAL 61
+
+static __thread struct hc_worker *executor_worker = NULL;
+
+// Only the owner pushes, at the bottom; everyone including the owner
+// takes from the top.
+
+static void deque_init(struct hc_task_deque *d, const size_t size) {
+  size_t n = 1;
+  while (n < size) { n <<= 1; }
+  d->top = d->bottom = 0;
+  d->items = malloc(n * sizeof(struct hc_task *));
+  d->mask = n - 1;
+}
+
+static bool deque_push(struct hc_task_deque *d, struct hc_task *t) {
+  const int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+  const int64_t top = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+  if (b - top > d->mask) { return false; }
+  __atomic_store_n(d->items + (b & d->mask), t, __ATOMIC_RELAXED);
+  __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+static struct hc_task *deque_steal(struct hc_task_deque *d) {
+  int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+  
+  for (;;) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    const int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) { return NULL; }
+
+    struct hc_task *x =
+      __atomic_load_n(d->items + (t & d->mask), __ATOMIC_RELAXED);
+
+    // Failing updates t with the current top.
+    if (__atomic_compare_exchange_n(&d->top, &t, t + 1, false,
+				    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+      return x;
+    }
+  }
+}
+
+// Sleeping workers announce themselves before checking for work a final
+// time, the fences make sure that either they find the task or we find
+// them.
+
+static void executor_notify(struct hc_executor *e) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(&e->sleeping, __ATOMIC_RELAXED)) {
+    pthread_mutex_lock(&e->lock);
+    pthread_cond_signal(&e->wake);
+    pthread_mutex_unlock(&e->lock);
+  }
+}
+
+static void executor_inject(struct hc_executor *e, struct hc_task *t) {
+  pthread_mutex_lock(&e->lock);
+  hc_list_push_back(&e->injected, &t->list);
+  if (e->sleeping) { pthread_cond_signal(&e->wake); }
+  pthread_mutex_unlock(&e->lock);
+}
+
+static void worker_push(struct hc_worker *w, struct hc_task *t) {
+  if (deque_push(&w->deque, t)) {
+    executor_notify(w->executor);
+  } else {
+    executor_inject(w->executor, t);
+  }
+}
+
+// Expects the lock to be held, moves a batch of injected tasks to the
+// local deque and returns the first one.
+
+static struct hc_task *worker_inject(struct hc_worker *w, size_t *n) {
+  struct hc_list *i = hc_list_pop_front(&w->executor->injected);
+  if (!i) { return NULL; }
+  
+  for (*n = 0; *n < EXECUTOR_BATCH; (*n)++) {
+    struct hc_list *j = hc_list_peek_front(&w->executor->injected);
+    
+    if (!j || !deque_push(&w->deque, hc_baseof(j, struct hc_task, list))) {
+      break;
+    }
+
+    hc_list_delete(j);
+  }
+
+  return hc_baseof(i, struct hc_task, list);
+}
+
+static struct hc_task *worker_injected(struct hc_worker *w) {
+  size_t n = 0;
+  pthread_mutex_lock(&w->executor->lock);
+  struct hc_task *t = worker_inject(w, &n);
+  pthread_mutex_unlock(&w->executor->lock);
+  if (n) { executor_notify(w->executor); }
+  return t;
+}
+
+static struct hc_task *worker_steal(struct hc_worker *w) {
+  struct hc_executor *e = w->executor;
+  const int n = e->opts.workers;
+  
+  // Xorshift, starts at a random victim to spread the contention.
+  w->seed ^= w->seed << 13;
+  w->seed ^= w->seed >> 7;
+  w->seed ^= w->seed << 17;
+  const int start = w->seed % n;
+
+  for (int i = 0; i < n; i++) {
+    struct hc_worker *v = e->workers + (start + i) % n;
+    if (v == w) { continue; }
+    struct hc_task *t = deque_steal(&v->deque);
+    if (t) { return t; }
+  }
+
+  return NULL;
+}
+
+static struct hc_task *worker_next(struct hc_worker *w) {
+  struct hc_task *t = NULL;
+
+  // Tasks that keep yielding would otherwise starve the injection queue.
+  if (!(++w->tick % EXECUTOR_INJECT_INTERVAL) && (t = worker_injected(w))) {
+    return t;
+  }
+
+  if ((t = deque_steal(&w->deque)) || (t = worker_injected(w))) {
+    return t;
+  }
+  
+  return worker_steal(w);
+}
+
+static struct hc_task *worker_sleep(struct hc_worker *w) {
+  struct hc_executor *e = w->executor;
+  struct hc_task *t = NULL;
+  size_t n = 0;
+  pthread_mutex_lock(&e->lock);
+  __atomic_add_fetch(&e->sleeping, 1, __ATOMIC_SEQ_CST);
+
+  while (!__atomic_load_n(&e->stop, __ATOMIC_RELAXED) &&
+	 !(t = worker_inject(w, &n)) &&
+	 !(t = worker_steal(w))) {
+    pthread_cond_wait(&e->wake, &e->lock);
+  }
+
+  __atomic_sub_fetch(&e->sleeping, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&e->lock);
+  if (n) { executor_notify(e); }
+  return t;
+}
+
+static void worker_exec(struct hc_worker *w, struct hc_task *t) {
+  t->body(t);
+
+  if (!t->done) {
+    worker_push(w, t);
+    return;
+  }
+  
+  struct hc_executor *e = w->executor;
+  
+  // The task may be freed by a waiting thread from here on.
+  if (!__atomic_sub_fetch(&e->pending, 1, __ATOMIC_ACQ_REL)) {
+    pthread_mutex_lock(&e->lock);
+    pthread_cond_broadcast(&e->idle);
+    pthread_mutex_unlock(&e->lock);
+  }
+}
+
+static void *worker_run(void *arg) {
+  struct hc_worker *w = arg;
+  struct hc_executor *e = w->executor;
+  executor_worker = w;
+  
+  while (!__atomic_load_n(&e->stop, __ATOMIC_RELAXED)) {
+    struct hc_task *t = worker_next(w);
+    if (!t && !(t = worker_sleep(w))) { break; }
+    worker_exec(w, t);
+  }
+
+  return NULL;
+}
+
+static void executor_stop(struct hc_executor *e, const int n) {
+  pthread_mutex_lock(&e->lock);
+  __atomic_store_n(&e->stop, true, __ATOMIC_RELAXED);
+  pthread_cond_broadcast(&e->wake);
+  pthread_mutex_unlock(&e->lock);
+
+  // Workers may still be stealing from each other until every one of
+  // them has stopped.
+  for (int i = 0; i < n; i++) {
+    pthread_join(e->workers[i].thread, NULL);
+  }
+}
+
+static void executor_free(struct hc_executor *e) {
+  for (int i = 0; i < e->opts.workers; i++) {
+    free(e->workers[i].deque.items);
+  }
+
+  free(e->workers);
+  pthread_cond_destroy(&e->idle);
+  pthread_cond_destroy(&e->wake);
+  pthread_mutex_destroy(&e->lock);
+}
+
+struct hc_executor *_hc_executor_init(struct hc_executor *e,
+				      struct hc_executor_opts opts) {
+  if (opts.workers <= 0) {
+    opts.workers = hc_max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+  }
+  
+  e->opts = opts;
+  pthread_mutex_init(&e->lock, NULL);
+  pthread_cond_init(&e->wake, NULL);
+  pthread_cond_init(&e->idle, NULL);
+  hc_list_init(&e->injected);
+  e->pending = e->sleeping = 0;
+  e->stop = false;
+  
+  e->workers = aligned_alloc(alignof(struct hc_worker),
+			     opts.workers * sizeof(struct hc_worker));
+
+  for (int i = 0; i < opts.workers; i++) {
+    struct hc_worker *w = e->workers + i;
+    w->executor = e;
+    deque_init(&w->deque, opts.deque_size);
+    w->seed = i + 1;
+    w->tick = 0;
+    w->id = i;
+  }
+  
+  for (int i = 0; i < opts.workers; i++) {
+    struct hc_worker *w = e->workers + i;
+    
+    const int r = pthread_create(&w->thread, NULL, worker_run, w);
+
+    // Workers that did start are stopped before giving up.
+    if (r) {
+      executor_stop(e, i);
+      executor_free(e);
+      hc_throw("Failed creating thread: %d", r);
+    }
+  }
+
+  return e;
+}
+
+void hc_executor_deinit(struct hc_executor *e) {
+  executor_stop(e, e->opts.workers);
+  executor_free(e);
+}
+
+void hc_executor_spawn(struct hc_executor *e,
+		       struct hc_task *t,
+		       hc_task_body body) {
+  t->owner = NULL;
+  t->body = body;
+  t->state = 0;
+  t->done = t->parked = false;
+  hc_timer_init(&t->timer, task_timeout);
+  __atomic_add_fetch(&e->pending, 1, __ATOMIC_RELAXED);
+  struct hc_worker *w = executor_worker;
+
+  // Tasks spawned by other tasks stay on the same worker until stolen.
+  if (w && w->executor == e) {
+    worker_push(w, t);
+  } else {
+    executor_inject(e, t);
+  }
+}
+
+void hc_executor_wait(struct hc_executor *e) {
+  pthread_mutex_lock(&e->lock);
+
+  while (__atomic_load_n(&e->pending, __ATOMIC_ACQUIRE)) {
+    pthread_cond_wait(&e->idle, &e->lock);
+  }
+  
+  pthread_mutex_unlock(&e->lock);
+}
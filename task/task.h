@@ -1,36 +1,117 @@
-#ifndef HACKTICAL_TASK_H
-#define HACKTICAL_TASK_H
-
-#include <stdbool.h>
-#include "list/list.h"
-
-#define hc_task_yield(task)			\
-  do {						\
-    task->state = __LINE__;			\
-    return;					\
-    case __LINE__:;			        \
-  } while (0)				      
-
-struct hc_task;
-
-typedef void (*hc_task_body)(struct hc_task *);
-
-struct hc_task {
-  struct hc_list list;
-  hc_task_body body;
-  int state;
-  bool done;
-};
-
-struct hc_task_list {
-  struct hc_list tasks;
-};
-
-struct hc_task *hc_task_init(struct hc_task *t,
-			     struct hc_task_list *tl,
-			     hc_task_body body);
-
-struct hc_task_list *hc_task_list_init(struct hc_task_list *tl);
-void hc_task_list_run(const struct hc_task_list *tl);
-
-#endif
+#ifndef HACKTICAL_TASK_H
+#define HACKTICAL_TASK_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "chrono/chrono.h"
+#include "list/list.h"
+
+#define hc_task_yield(task)			\
+  do {						\
+    task->state = __LINE__;			\
+    return;					\
+    case __LINE__:;			        \
+  } while (0)				      
+
+#define hc_task_wait(task)			\
+  do {						\
+    hc_task_park(task);				\
+    hc_task_yield(task);			\
+  } while (0)
+
+#define hc_task_sleep(task, ns)			\
+  do {						\
+    hc_task_park_for((task), (ns));		\
+    hc_task_yield(task);			\
+  } while (0)
+
+struct hc_task;
+struct hc_task_list;
+
+typedef void (*hc_task_body)(struct hc_task *);
+
+struct hc_task {
+  struct hc_list list;
+  struct hc_task_list *owner;
+  hc_task_body body;
+  int state;
+  bool done, parked;
+  struct hc_timer timer;
+};
+
+struct hc_task_list {
+  struct hc_list ready, parked;
+  struct hc_timer_wheel timers;
+};
+
+struct hc_task *hc_task_init(struct hc_task *t,
+			     struct hc_task_list *tl,
+			     hc_task_body body);
+
+struct hc_task_list *hc_task_list_init(struct hc_task_list *tl);
+void hc_task_list_run(struct hc_task_list *tl);
+void hc_task_park(struct hc_task *t);
+void hc_task_park_for(struct hc_task *t, uint64_t ns);
+void hc_task_wake(struct hc_task *t);
+
+/* Executor */
+
+#define HC_EXECUTOR_CACHE_LINE 64
+#define HC_EXECUTOR_DEQUE_SIZE 1024
+
+struct hc_executor;
+
+struct hc_task_deque {
+  // Written by thieves as well as the owner.
+  alignas(HC_EXECUTOR_CACHE_LINE) int64_t top;
+
+  // Only written by the owner.
+  alignas(HC_EXECUTOR_CACHE_LINE) int64_t bottom;
+  struct hc_task **items;
+  int64_t mask;
+};
+
+struct hc_worker {
+  struct hc_executor *executor;
+  struct hc_task_deque deque;
+  pthread_t thread;
+  uint64_t seed, tick;
+  int id;
+};
+
+struct hc_executor_opts {
+  int workers;
+  size_t deque_size;
+};
+
+struct hc_executor {
+  struct hc_executor_opts opts;
+  struct hc_worker *workers;
+  pthread_mutex_t lock;
+  pthread_cond_t wake, idle;
+  struct hc_list injected;
+  size_t pending, sleeping;
+  bool stop;
+};
+
+#define hc_executor_init(e, ...)				\
+  _hc_executor_init(e, (struct hc_executor_opts){		\
+      .workers = 0,						\
+      .deque_size = HC_EXECUTOR_DEQUE_SIZE,			\
+      ##__VA_ARGS__						\
+    })
+
+struct hc_executor *_hc_executor_init(struct hc_executor *e,
+				      struct hc_executor_opts opts);
+
+void hc_executor_deinit(struct hc_executor *e);
+
+void hc_executor_spawn(struct hc_executor *e,
+		       struct hc_task *t,
+		       hc_task_body body);
+
+void hc_executor_wait(struct hc_executor *e);
+
+#endif
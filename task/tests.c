@@ -1,54 +1,254 @@
-#include <assert.h>
-#include <stdio.h>
-#include "task.h"
-
-struct my_task {
-  struct hc_task task;
-  int *value;
-};
-
-static void producer(struct hc_task *task) {
-  int *value = hc_baseof(task, struct my_task, task)->value;
-  
-  switch (task->state) {
-  case 0:
-    assert(*value == 0);
-    (*value)++;
-    hc_task_yield(task);
-    assert(*value == 2);
-    (*value)++;
-  }
-  
-  task->done = true;
-}
-
-static void consumer(struct hc_task *task) {
-  int *value = hc_baseof(task, struct my_task, task)->value;
-
-  switch (task->state) {
-  case 0:
-    assert(*value == 1);
-    (*value)++;
-    hc_task_yield(task);
-    assert(*value == 3);
-    (*value)++;
-  }
-  
-  task->done = true;
-}
-  
-void task_tests() {
-  struct hc_task_list tl;
-  hc_task_list_init(&tl);
-  
-  int value = 0;  
-
-  struct my_task pt = {.value = &value};
-  hc_task_init(&pt.task, &tl, &producer);
-
-  struct my_task ct = {.value = &value};
-  hc_task_init(&ct.task, &tl, &consumer);
-
-  hc_task_list_run(&tl);
-  assert(value == 4);
-}
+#include <assert.h>
+#include <stdio.h>
+#include "task.h"
+
+struct my_task {
+  struct hc_task task;
+  int *value;
+};
+
+static void producer(struct hc_task *task) {
+  int *value = hc_baseof(task, struct my_task, task)->value;
+  
+  switch (task->state) {
+  case 0:
+    assert(*value == 0);
+    (*value)++;
+    hc_task_yield(task);
+    assert(*value == 2);
+    (*value)++;
+  }
+  
+  task->done = true;
+}
+
+static void consumer(struct hc_task *task) {
+  int *value = hc_baseof(task, struct my_task, task)->value;
+
+  switch (task->state) {
+  case 0:
+    assert(*value == 1);
+    (*value)++;
+    hc_task_yield(task);
+    assert(*value == 3);
+    (*value)++;
+  }
+  
+  task->done = true;
+}
+  
+struct sleep_task {
+  struct hc_task task;
+  uint64_t ns;
+  int *order, *count;
+  int id;
+};
+
+static void sleeper(struct hc_task *task) {
+  struct sleep_task *t = hc_baseof(task, struct sleep_task, task);
+
+  switch (task->state) {
+  case 0:
+    hc_task_sleep(task, t->ns);
+    t->order[(*t->count)++] = t->id;
+  }
+
+  task->done = true;
+}
+
+static void sleep_tests() {
+  struct hc_task_list tl;
+  hc_task_list_init(&tl);
+  int order[3], count = 0;
+  
+  struct sleep_task ts[] = {
+    {.ns = 30000000, .order = order, .count = &count, .id = 0},
+    {.ns = 10000000, .order = order, .count = &count, .id = 1},
+    {.ns = 20000000, .order = order, .count = &count, .id = 2}
+  };
+
+  for (int i = 0; i < 3; i++) {
+    hc_task_init(&ts[i].task, &tl, &sleeper);
+  }
+
+  const hc_ns_t start = hc_ns();
+  hc_task_list_run(&tl);
+  assert(hc_ns() - start >= 30000000);
+  assert(count == 3);
+  assert(order[0] == 1 && order[1] == 2 && order[2] == 0);
+}
+
+struct wait_task {
+  struct hc_task task;
+  struct hc_task *other;
+  int *value;
+};
+
+static void waiter(struct hc_task *task) {
+  struct wait_task *t = hc_baseof(task, struct wait_task, task);
+  
+  switch (task->state) {
+  case 0:
+    hc_task_wait(task);
+    assert(*t->value == 1);
+    (*t->value)++;
+  }
+
+  task->done = true;
+}
+
+static void waker(struct hc_task *task) {
+  struct wait_task *t = hc_baseof(task, struct wait_task, task);
+
+  switch (task->state) {
+  case 0:
+    // Gives the waiter a chance to park.
+    hc_task_yield(task);
+    assert(t->other->parked);
+    (*t->value)++;
+    hc_task_wake(t->other);
+  }
+
+  task->done = true;
+}
+
+static void wait_tests() {
+  struct hc_task_list tl;
+  hc_task_list_init(&tl);
+  int value = 0;
+  
+  struct wait_task wt = {.value = &value};
+  hc_task_init(&wt.task, &tl, &waiter);
+
+  struct wait_task kt = {.other = &wt.task, .value = &value};
+  hc_task_init(&kt.task, &tl, &waker);
+
+  // Never woken up.
+  struct wait_task it = {.value = &value};
+  hc_task_init(&it.task, &tl, &waiter);
+
+  hc_task_list_run(&tl);
+  assert(value == 2);
+  assert(hc_list_nil(&tl.ready));
+  assert(tl.parked.next == &it.task.list && tl.parked.prev == &it.task.list);
+  assert(hc_list_nil(&wt.task.list) && hc_list_nil(&kt.task.list));
+}
+
+static void parker(struct hc_task *task) {
+  struct wait_task *t = hc_baseof(task, struct wait_task, task);
+  hc_task_park_for(t->other, 1000);
+  task->done = true;
+}
+
+static void parkee(struct hc_task *task) {
+  struct wait_task *t = hc_baseof(task, struct wait_task, task);
+  (*t->value)++;
+  task->done = true;
+}
+
+static void park_tests() {
+  // Parks the last ready task before it gets to run, it's woken up
+  // again by the timer.
+  struct hc_task_list tl;
+  hc_task_list_init(&tl);
+  int value = 0;
+  
+  struct wait_task pt = {.value = &value};
+  hc_task_init(&pt.task, &tl, &parker);
+
+  struct wait_task et = {.value = &value};
+  hc_task_init(&et.task, &tl, &parkee);
+  pt.other = &et.task;
+  
+  hc_task_list_run(&tl);
+  assert(value == 1);
+  assert(hc_list_nil(&tl.ready) && hc_list_nil(&tl.parked));
+}
+
+struct spawn_task {
+  struct hc_task task;
+  struct hc_executor *executor;
+  struct my_task *children;
+  int n, steps, *count;
+};
+
+static void spawner(struct hc_task *task) {
+  struct spawn_task *t = hc_baseof(task, struct spawn_task, task);
+
+  for (int i = 0; i < t->n; i++) {
+    hc_executor_spawn(t->executor, &t->children[i].task,
+		      (i % 2) ? &consumer : &producer);
+  }
+  
+  task->done = true;
+}
+
+static void stepper(struct hc_task *task) {
+  struct spawn_task *t = hc_baseof(task, struct spawn_task, task);
+
+  switch (task->state) {
+  case 0:
+    while (t->steps--) {
+      __atomic_add_fetch(t->count, 1, __ATOMIC_RELAXED);
+      hc_task_yield(task);
+    }
+  }
+
+  task->done = true;
+}
+
+static void executor_tests() {
+  // Unchanged tasks interleave the same way on a single worker.
+  struct hc_executor e;
+  hc_executor_init(&e, .workers = 1);
+  int value = 0;
+  struct my_task children[] = {{.value = &value}, {.value = &value}};
+  
+  struct spawn_task root = {
+    .executor = &e, .children = children, .n = 2
+  };
+
+  hc_executor_spawn(&e, &root.task, &spawner);
+  hc_executor_wait(&e);
+  assert(value == 4);
+  hc_executor_deinit(&e);
+
+  hc_executor_init(&e, .workers = 4, .deque_size = 16);
+  int count = 0;
+  struct spawn_task ts[100];
+
+  for (int i = 0; i < 100; i++) {
+    ts[i] = (struct spawn_task){.steps = 10, .count = &count};
+    hc_executor_spawn(&e, &ts[i].task, &stepper);
+  }
+
+  hc_executor_wait(&e);
+  assert(count == 1000);
+
+  for (int i = 0; i < 100; i++) {
+    assert(ts[i].task.done);
+  }
+  
+  hc_executor_deinit(&e);
+}
+
+void task_tests() {
+  struct hc_task_list tl;
+  hc_task_list_init(&tl);
+  
+  int value = 0;  
+
+  struct my_task pt = {.value = &value};
+  hc_task_init(&pt.task, &tl, &producer);
+
+  struct my_task ct = {.value = &value};
+  hc_task_init(&ct.task, &tl, &consumer);
+
+  hc_task_list_run(&tl);
+  assert(value == 4);
+  assert(hc_list_nil(&tl.ready));
+  sleep_tests();
+  wait_tests();
+  park_tests();
+  executor_tests();
+}